@@ -866,6 +866,31 @@ static mspan_t *cache_span(mcentral_t *mcentral) {
         goto HAVE_SPAN;
     }
 
+    // 惰性清理: 在 grow 之前优先清理 unswept span, 清理出空闲 obj 的 span 直接使用
+    for (int budget = SWEEP_SPAN_BUDGET; budget > 0; budget--) {
+        mspan_t *live = NULL;
+        if (!mcentral_sweep_one(mcentral, &live)) {
+            break;
+        }
+
+        if (!live) {
+            continue;
+        }
+
+        if (live->alloc_count < live->obj_count) {
+            span = live;
+            goto HAVE_SPAN;
+        }
+
+        RT_LIST_PUSH_HEAD(mcentral->full_list, live);
+    }
+
+    // 清理期间会释放锁, 其他线程可能归还了 span
+    if (mcentral->partial_list) {
+        RT_LIST_POP_HEAD(mcentral->partial_list, &span);
+        goto HAVE_SPAN;
+    }
+
     // 当前 mcentral 中已经没有可以使用的 mspan 需要走 grow 逻辑
     mcentral_grow(mcentral);
     assert(mcentral->partial_list && "out of memory: mcentral grow failed");
@@ -877,6 +902,7 @@ HAVE_SPAN:
            span->obj_count, span->alloc_count);
 
     assert(span && span->obj_count - span->alloc_count > 0 && "span unavailable");
+    assert(span->sweepgen == memory->mheap->sweepgen && "cache span not swept");
     mutex_unlock(&mcentral->locker);
     DEBUGF("[cache_span] success, unlocked mcentral=%p, span=%p, base=%p, spc=%d, obj_count=%lu, alloc_count=%lu",
            mcentral, span,
@@ -1276,6 +1302,10 @@ void memory_init() {
     allocated_bytes = 0;
     next_gc_bytes = MIN_GC_BYTES;
 
+    // NATURE_GC_MODE=generational 开启分代模式, 默认每一轮都是 full gc
+    char *gc_mode = getenv("NATURE_GC_MODE");
+    gc_generational = gc_mode && str_equal(gc_mode, "generational");
+
     // - 初始化 mheap
     mheap_t *mheap = mallocz_big(sizeof(mheap_t)); // 所有的结构体，数组初始化为 0, 指针初始化为 null
     mheap->page_alloc.summary[4] = mallocz_big(PAGE_SUMMARY_COUNT_L4 * sizeof(page_summary_t));
@@ -1406,7 +1436,7 @@ mspan_t *mspan_new(uint64_t base, uint64_t pages_count, uint8_t spanclass) {
     span->pages_count = pages_count;
     span->alloc_count = 0;
     span->free_index = 0;
-    span->sweepgen = 0;
+    span->sweepgen = memory->mheap->sweepgen; // 新的 span 不需要清理
     span->spanclass = spanclass;
     uint8_t sizeclass = take_sizeclass(spanclass);
     if (sizeclass == LARGE_SIZECLASS) {
@@ -3,15 +3,16 @@
 #include "memory.h"
 #include "processor.h"
 
-static void insert_gc_worklist(rt_linked_fixalloc_t *gc_worklist, void *ptr) {
+static void insert_gc_worklist(rt_worklist_t *gc_worklist, void *ptr) {
     assert(span_of((addr_t) ptr) && "ptr not found in active span");
-    n_processor_t *p = processor_get();
-    if (p) {
-        DEBUGF("[insert_gc_worklist] p_index=%d, p=%p, ptr=%p", p->index, gc_worklist, ptr);
-    } else {
-        DEBUGF("[insert_gc_worklist] global worklist, p=%p, ptr=%p", gc_worklist, ptr);
-    }
-    rt_linked_fixalloc_push(gc_worklist, ptr);
+    DEBUGF("[insert_gc_worklist] worklist=%p, ptr=%p", gc_worklist, ptr);
+    rt_worklist_push(gc_worklist, ptr);
+}
+
+static void insert_global_gc_worklist(void *ptr) {
+    assert(span_of((addr_t) ptr) && "ptr not found in active span");
+    DEBUGF("[insert_global_gc_worklist] ptr=%p", ptr);
+    rt_linked_fixalloc_push(&global_gc_worklist, ptr);
 }
 
 /**
@@ -50,7 +51,7 @@ void shade_obj_grey(void *obj) {
     if (p && p->gc_work_finished < memory->gc_count) {
         insert_gc_worklist(&p->gc_worklist, obj);
     } else {
-        insert_gc_worklist(&global_gc_worklist, obj);
+        insert_global_gc_worklist(obj);
     }
 }
 
@@ -148,13 +149,19 @@ static void free_mspan_meta(mspan_t *span) {
 
 /**
  * 如果 span 清理完成后 alloc_count == 0 则将其归还给 heap
+ * 调用方需要先将 span 从 mcentral 的 unswept 链表中取出，清理期间不持有 mcentral 锁, 其他线程无法访问该 span
  * @param span span 是否被释放，如果释放了需要将其从 list 中抹除
  */
-static bool sweep_span(mcentral_t *central, mspan_t *span) {
+static bool sweep_span(mspan_t *span) {
     // 但是此时 span 其实并没有真的被释放,只有 alloc_count = 0 时才会触发真正的释放操作, 这里记录更新一下分配的内存值
     assert(span);
     assert(span->base > 0);
 
+    uint32_t sweepgen = memory->mheap->sweepgen;
+    assertf(span->sweepgen == sweepgen - 2, "span=%p sweepgen=%u already swept, mheap sweepgen=%u", span,
+            span->sweepgen, sweepgen);
+    span->sweepgen = sweepgen - 1;
+
 #if defined(__DARWIN) && defined(__ARM64)
     assert(span->obj_count > 0 && span->obj_count <= 2048); // darwin/arm64 一页是 16k
 #else
@@ -204,6 +211,10 @@ static bool sweep_span(mcentral_t *central, mspan_t *span) {
            (void *) span->base, span->spanclass)
     span->alloc_bits = span->gcmark_bits;
     span->gcmark_bits = gcbits_new(span->obj_count);
+    if (memory->mheap->sticky_mark) {
+        // 存活的 obj 晋升为 old obj, 下一轮 minor gc 遇到已经标记的 obj 时不会再向下扫描
+        memcpy(span->gcmark_bits, span->alloc_bits, (span->obj_count + 7) / 8);
+    }
     span->alloc_count = alloc_count;
     span->free_index = free_index == -1 ? 0 : free_index;
 
@@ -214,111 +225,125 @@ static bool sweep_span(mcentral_t *central, mspan_t *span) {
 
     RDEBUGF("[sweep_span] reset gcmark_bits success, span=%p, spc=%d", span, span->spanclass)
 
-    uint8_t sizeclass = take_sizeclass(span->spanclass);
+    span->sweepgen = sweepgen;
 
     // span 所有的 obj 都被释放，归还 span 内存给操作系统,
     // JIT span 不做 free, jit span 无法进行任何的写入操作
     if (span->alloc_count == 0) {
         TRACEF("[sweep_span] span will free to heap, span=%p, base=0x%lx, class=%d", span, span->base, span->spanclass);
 
+        // 与 mheap_alloc_span 竞争 page_alloc 和 spanalloc
+        mutex_lock(&memory->locker);
         mheap_free_span(memory->mheap, span);
         TRACEF("[sweep_span] span success free to heap, span=%p, base=0x%lx, class=%d", span, span->base,
                span->spanclass);
 
         free_mspan_meta(span);
+        mutex_unlock(&memory->locker);
         TRACEF("[sweep_span] span success free meta, span=%p, base=0x%lx, class=%d", span, span->base, span->spanclass);
 
         return true;
     }
 
-    if (span->alloc_count == span->obj_count) {
-        RT_LIST_PUSH_HEAD(central->full_list, span);
-    } else {
-        RT_LIST_PUSH_HEAD(central->partial_list, span);
+    return false;
+}
+
+/**
+ * 需要持有 central->locker, 从 unswept 链表中取出一个 span 进行清理, 清理期间会临时释放 central->locker
+ * 经过 sweep full -> part，或者直接清零规划给 mheap, 但是绝对不会从 part 到 full, 所以优先清理 partial
+ * @param live 清理后仍然存在 obj 的 span, 由调用方放回 mcentral 或者直接使用, span 归还给 mheap 时为 null
+ * @return 没有需要清理的 span 时返回 false
+ */
+bool mcentral_sweep_one(mcentral_t *central, mspan_t **live) {
+    mspan_t *span = NULL;
+    RT_LIST_POP_HEAD(central->unswept_partial_list, &span);
+    if (!span) {
+        RT_LIST_POP_HEAD(central->unswept_full_list, &span);
+    }
+    if (!span) {
+        return false;
     }
 
-    return false;
+    atomic_fetch_add(&memory->mheap->sweepers, 1);
+    mutex_unlock(&central->locker);
+
+    RDEBUGF("[mcentral_sweep_one] will sweep span, span=%p, span_base=%p, spc=%d", (void *) span,
+            (void *) span->base, span->spanclass);
+    bool freed = sweep_span(span);
+
+    mutex_lock(&central->locker);
+    atomic_fetch_sub(&memory->mheap->sweepers, 1);
+
+    *live = freed ? NULL : span;
+    return true;
 }
 
 /**
- * 遍历 所有 mcentral 的 full 和 partial 进行清理
+ * stw 期间调用, 此时所有的 mcache 都已经 flush, 将所有 mcentral 中的 span 标记为 unswept
  * - 只有是被 span 持有的 page， 在 page_alloc 眼里就是被分配了出去，所以不需要对 chunk 进行修改什么的
  * - 并不需要真的清理 obj, 只需要将 gc_bits 和 alloc_bits 调换一下位置，然后从新计算 alloc_count 即可
  * - 当 gc 完成后 alloc_count = 0, 就需要考虑是否需要将该 span 归还到 mheap 中了
  * - sweep 时 arena_t 的 bits 是否需要更新？
  *   空闲的 obj 进行 alloc 时一定会进行 set bits, 所以所有忙碌的 obj 的 bits 一定是有效的。
  *   空闲的 obj 的 bits 即使是脏的，三色标记时也一定无法标记到该 obj, 因为其不在引用链中
- *
- *   当前处于 stw，唯一可能操作 central 的就是 wait_sysmon 的 processor_free, 由于前面已经全量 uncache 过了
- *   所以此时也不再有新的 processor free uncache 了，所以不需要再加 central 锁, memory 锁也有点多余，这里加上做个保险
- * @param mheap
+ * - sticky_mark 表示下一轮是 minor gc, sweep 时保留存活 obj 的 gcmark_bits
  */
-void mcentral_sweep(mheap_t *mheap) {
-    RDEBUGF("[mcentral_sweep] start");
-    mutex_lock(&memory->locker);
-
+static void mcentral_sweep_prepare(mheap_t *mheap, bool sticky_mark) {
     remove_total_bytes = 0;
+    mheap->sticky_mark = sticky_mark;
 
     mcentral_t *centrals = mheap->centrals;
     for (int i = 0; i < SPANCLASS_COUNT; ++i) {
         mcentral_t *central = &centrals[i];
-        if (!central->partial_list && !central->full_list) {
-            continue;
-        }
 
-        RDEBUGF("[mcentral_sweep] will handle central spc=%hhu", central->spanclass);
-        // full and partial
-        mspan_t *full_list = central->full_list;
-        mspan_t *partial_list = central->partial_list;
+        // 上一轮的 sweep 必须在下一轮 gc 开始之前完成, 否则 gcbits 的 epoch 会释放仍然被引用的 bits
+        assertf(!central->unswept_partial_list && !central->unswept_full_list,
+                "spc=%d unswept span exists before sweep prepare", i);
 
-        // 清空链表进行重新注册
+        central->unswept_partial_list = central->partial_list;
+        central->unswept_full_list = central->full_list;
         central->partial_list = NULL;
         central->full_list = NULL;
+    }
 
-        // #ifdef DEBUG
-        //         mspan_t *p = full_list;
-        //         while (p) {
-        //             RDEBUGF("[mcentral_sweep] spc=%d full current=%p, next=%p", i, p, p->next);
-        //             p = p->next;
-        //         }
-        //         p = partial_list;
-        //         while (p) {
-        //             RDEBUGF("[mcentral_sweep] spc=%d partial current=%p, next=%p", i, p, p->next);
-        //             p = p->next;
-        //         }
-        // #endif
-
-        // 经过 sweep full -> part，或者直接清零规划给 mheap, 但是绝对不会从 part 到 full
-        mspan_t *current = full_list;
-        mspan_t *next = NULL;
-        while (current) {
-            next = current->next;
-            current->next = NULL;
-            RDEBUGF("[mcentral_sweep] will sweep full span, span=%p, span_base=%p, next=%p", (void *) current,
-                    (void *) current->base, next);
-            bool swept = sweep_span(central, current);
-            RDEBUGF("[mcentral_sweep] success sweep full span, span=%p, swept=%d", (void *) current, swept);
-
-            current = next;
-        }
+    // 所有 span 的 sweepgen 都等于 sweepgen - 2, 进入 unswept 状态
+    mheap->sweepgen += 2;
+}
+
+/**
+ * gc 线程在 start the world 之后进行后台清理, 与 cache_span 中的按需清理竞争 unswept span
+ */
+void mcentral_sweep(mheap_t *mheap) {
+    RDEBUGF("[mcentral_sweep] start");
 
-        current = partial_list;
-        while (current) {
-            next = current->next;
+    mcentral_t *centrals = mheap->centrals;
+    for (int i = 0; i < SPANCLASS_COUNT; ++i) {
+        mcentral_t *central = &centrals[i];
+        mutex_lock(&central->locker);
 
-            current->next = NULL;
-            RDEBUGF("[mcentral_sweep] will sweep partial span, span=%p, next=%p", (void *) current, next);
-            bool swept = sweep_span(central, current);
-            RDEBUGF("[mcentral_sweep] success sweep partial span swept=%d", swept);
+        mspan_t *span = NULL;
+        while (mcentral_sweep_one(central, &span)) {
+            if (!span) {
+                continue;
+            }
 
-            current = next;
+            if (span->alloc_count == span->obj_count) {
+                RT_LIST_PUSH_HEAD(central->full_list, span);
+            } else {
+                RT_LIST_PUSH_HEAD(central->partial_list, span);
+            }
         }
+
+        mutex_unlock(&central->locker);
     }
 
-    mutex_unlock(&memory->locker);
-    RDEBUGF("[mcentral_sweep] start");
-}
+    // 等待 cache_span 中正在进行的清理完成
+    while (atomic_load(&mheap->sweepers) > 0) {
+        usleep(WAIT_BRIEF_TIME * 1000);
+    }
 
+    RDEBUGF("[mcentral_sweep] end");
+}
 
 /**
  * save_stack 中保存着 coroutine 栈数组，其中 stack->ptr 指向了原始栈的栈顶
@@ -328,7 +353,7 @@ void mcentral_sweep(mheap_t *mheap) {
  * 寄存器会在 co_preempt_yield 保存到 acosw 函数汇编申请的栈空间中。此时需要采取保守的栈扫描策略，将可能存在的 ptr 加入到 gc mark 中
  */
 #if defined(__AMD64) && defined(__WINDOWS)
-static void scan_windows_context_roots(rt_linked_fixalloc_t *worklist,
+static void scan_windows_context_roots(rt_worklist_t *worklist,
                                        const aco_t *aco) {
     for (int i = ACO_REG_IDX_GP_NONVOL_FIRST;
          i <= ACO_REG_IDX_GP_NONVOL_LAST; ++i) {
@@ -340,7 +365,7 @@ static void scan_windows_context_roots(rt_linked_fixalloc_t *worklist,
 }
 #endif
 
-static void scan_saved_stack_conservative(rt_linked_fixalloc_t *worklist,
+static void scan_saved_stack_conservative(rt_worklist_t *worklist,
                                           const aco_save_stack_t *save_stack) {
     if (!save_stack->ptr || save_stack->valid_sz == 0) {
         return;
@@ -376,7 +401,7 @@ static void scan_stack(n_processor_t *p, coroutine_t *co) {
     assert(p->gc_work_finished < memory->gc_count && "gc work finished, cannot insert to gc worklist");
 
     // solo processor 的 gc_worklist 无法使用，需要使用 share processor 进行辅助
-    rt_linked_fixalloc_t *worklist = &p->gc_worklist;
+    rt_worklist_t *worklist = &p->gc_worklist;
 
 #if defined(__AMD64) && defined(__WINDOWS)
     // Microsoft x64 allows heap pointers to remain live in nonvolatile GP
@@ -709,7 +734,7 @@ static void handle_gc_ptr(n_processor_t *p, addr_t addr) {
                 if (p && p->gc_work_finished < memory->gc_count) {
                     insert_gc_worklist(&p->gc_worklist, (void *) value);
                 } else {
-                    insert_gc_worklist(&global_gc_worklist, (void *) value);
+                    insert_global_gc_worklist((void *) value);
                 }
             } else {
                 DEBUGF("[handle_gc_ptr] skip, cursor=%p, ptr=%p, in_heap=%d, span_of=%p", (void *) temp_addr,
@@ -750,7 +775,7 @@ static void handle_gc_worklist(n_processor_t *p) {
             break;
         }
 
-        addr_t addr = (addr_t) rt_linked_fixalloc_pop(&p->gc_worklist);
+        addr_t addr = (addr_t) rt_worklist_pop(&p->gc_worklist);
 
         // handle 的同时会进一步 push
         handle_gc_ptr(p, addr);
@@ -811,6 +836,12 @@ static void gc_work() {
             insert_gc_worklist(&share_p->gc_worklist, wait_co->arg);
         }
 
+        // go 表达式的返回值被丢弃时 future 只被 co 持有, co 退出前仍然需要写入 result/error/co
+        if (span_of((addr_t) wait_co->future)) {
+            DEBUGF("[runtime_gc.gc_work] co=%p future=%p in heap and span, need gc mark", wait_co, wait_co->future);
+            insert_gc_worklist(&share_p->gc_worklist, wait_co->future);
+        }
+
         // 只有第一次 resume 时才会初始化 co, 申请堆栈，并且绑定对应的 p
         if (!wait_co->aco.inited) {
             DEBUGF("[runtime_gc.gc_work] co=%p, fn=%p not init, will skip", wait_co, wait_co->fn);
@@ -862,7 +893,7 @@ static void inject_gc_work_coroutine() {
         coroutine_t *gc_co = rt_coroutine_new((void *) gc_work, FLAG(CO_FLAG_RTFN) | FLAG(CO_FLAG_DIRECT), 0, NULL);
 
         rt_linked_fixalloc_push(&p->co_list, gc_co);
-        rt_linked_fixalloc_push(&p->runnable_list, gc_co);
+        processor_runnable_push(p, gc_co);
     }
 
     RDEBUGF("[runtime_gc.inject_gc_work_coroutine] inject gc work coroutine completed");
@@ -890,7 +921,7 @@ static void scan_pool() {
             assert(span_of((addr_t) linkco));
             DEBUGF("[runtime_gc.scan_pool] share p: %d, linkco %p, index %d", p->index, linkco, i);
 
-            rt_linked_fixalloc_push(&p->gc_worklist, linkco);
+            rt_worklist_push(&p->gc_worklist, linkco);
         }
     }
 
@@ -900,7 +931,7 @@ static void scan_pool() {
     mutex_lock(&const_str_pool_locker);
     sc_map_foreach_value(&const_str_pool, value) {
         if (value && span_of((addr_t) value->data)) {
-            rt_linked_fixalloc_push(&p->gc_worklist, value->data);
+            rt_worklist_push(&p->gc_worklist, value->data);
         }
     }
     mutex_unlock(&const_str_pool_locker);
@@ -928,7 +959,7 @@ static void scan_global() {
             if (span_of(addr)) {
                 // s.base 是 data 段中的地址， fetch_addr_value 则是取出该地址中存储的数据
                 // 从栈中取出指针数据值(并将该值加入到工作队列中)(这是一个堆内存的地址,该地址需要参与三色标记)
-                rt_linked_fixalloc_push(&p->gc_worklist, (void *) addr);
+                rt_worklist_push(&p->gc_worklist, (void *) addr);
             }
         } else if (rtype->storage_kind == STORAGE_KIND_IND) {
             int64_t current = s.base;
@@ -948,7 +979,7 @@ static void scan_global() {
                         DEBUGF("[runtime.scan_global] name=%s, kind=%s, base=%p(%p), index=%d, addr=%p need gc",
                                STRTABLE(s.name_offset), type_kind_str[rtype->kind], s.base, current, index, addr);
 
-                        rt_linked_fixalloc_push(&p->gc_worklist, (void *) addr);
+                        rt_worklist_push(&p->gc_worklist, (void *) addr);
                     } else {
                         DEBUGF("[runtime.scan_global] name=%s, kind=%s, base=%p(%p), index=%d, addr=%p not in span",
                                STRTABLE(s.name_offset), type_kind_str[rtype->kind], s.base, current, index, addr);
@@ -971,6 +1002,121 @@ static void scan_global() {
     RDEBUGF("[runtime_gc.scan_global] scan global completed");
 }
 
+/**
+ * card 中已经标记的 obj 是 old obj, 其中的指针可能指向上一轮 gc 之后分配的 young obj, 需要作为 root 加入到 worklist 中
+ * 未标记的 obj 要么是空闲的, 要么是 young obj, 可达的 young obj 一定会从其他 root 中被标记, 所以直接跳过
+ * card 不会跨越 page, 所以一个 card 只属于一个 span
+ */
+static void scan_card(n_processor_t *p, arena_t *arena, addr_t start) {
+    mspan_t *span = arena->spans[(start - arena->base) / ALLOC_PAGE_SIZE];
+    if (!span || !spanclass_has_ptr(span->spanclass)) {
+        return;
+    }
+
+    addr_t end = start + CARD_SIZE;
+    addr_t cursor = start;
+    while (cursor < end) {
+        uint64_t obj_index = (cursor - span->base) / span->obj_size;
+        if (obj_index >= span->obj_count) {
+            break;
+        }
+
+        addr_t obj_end = span->base + (obj_index + 1) * span->obj_size;
+        if (obj_end > end) {
+            obj_end = end;
+        }
+
+        if (!bitmap_test(span->gcmark_bits, obj_index)) {
+            cursor = obj_end;
+            continue;
+        }
+
+        for (; cursor < obj_end; cursor += POINTER_SIZE) {
+            if (!bitmap_test(arena->bits, arena_bits_index(arena, cursor))) {
+                continue;
+            }
+
+            addr_t value = fetch_addr_value(cursor);
+            if (span_of(value)) {
+                rt_worklist_push(&p->gc_worklist, (void *) value);
+            }
+        }
+    }
+}
+
+/**
+ * minor gc 在 stw 中扫描上一轮 gc 之后被写屏障标记的 card, 扫描完成后清空
+ * mark 期间新产生的 dirty card 会保留到下一轮, 虽然此时 young obj 都已经晋升, 但这不影响正确性
+ */
+static uint64_t scan_cards() {
+    n_processor_t *p = processor_index[0];
+    assert(p);
+
+    uint64_t count = 0;
+    mheap_t *mheap = memory->mheap;
+    for (int i = 0; i < mheap->arena_indexes->count; ++i) {
+        arena_t *arena = mheap->arenas[(uint64_t) mheap->arena_indexes->take[i]];
+        assert(arena);
+
+        uint64_t *words = (uint64_t *) arena->cards;
+        for (uint64_t j = 0; j < ARENA_CARDS_COUNT / sizeof(uint64_t); ++j) {
+            if (words[j] == 0) {
+                continue;
+            }
+
+            for (uint64_t k = j * sizeof(uint64_t); k < (j + 1) * sizeof(uint64_t); ++k) {
+                if (!arena->cards[k]) {
+                    continue;
+                }
+
+                arena->cards[k] = 0;
+                scan_card(p, arena, arena->base + (k << CARD_SHIFT));
+                count++;
+            }
+        }
+    }
+
+    DEBUGF("[runtime_gc.scan_cards] scan dirty cards completed, count=%lu", count);
+    return count;
+}
+
+/**
+ * full gc 会重新标记所有的 obj, 不需要 card 作为 root
+ */
+static void clear_cards() {
+    mheap_t *mheap = memory->mheap;
+    for (int i = 0; i < mheap->arena_indexes->count; ++i) {
+        arena_t *arena = mheap->arenas[(uint64_t) mheap->arena_indexes->take[i]];
+        memset(arena->cards, 0, ARENA_CARDS_COUNT);
+    }
+}
+
+static uint64_t gen_minor_streak = 0; // 上一次 full gc 之后连续 minor gc 的次数
+static int64_t gen_full_live = 0; // 上一次 full gc 之后存活的字节数
+static int64_t gen_last_live = 0; // 上一轮 gc 之后存活的字节数
+
+/**
+ * 在 stw 中决定下一轮 gc 的类型, sweep 根据结果决定是否保留 gcmark_bits
+ * old obj 中的垃圾只有 full gc 才能回收, 所以连续的 minor gc 达到上限, 或者上一轮 gc 之后存活的字节数
+ * 超过上一次 full gc 的两倍时, 下一轮进行 full gc
+ */
+static bool gen_next_minor(bool minor) {
+    if (!gc_generational) {
+        return false;
+    }
+
+    gen_minor_streak = minor ? gen_minor_streak + 1 : 0;
+    if (gen_minor_streak >= GC_GEN_FULL_INTERVAL) {
+        return false;
+    }
+
+    if (minor && gen_last_live > gen_full_live * 2) {
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * 处理剩余的 global gc worklist, 当前已经在 STW 了
  */
@@ -994,9 +1140,36 @@ static void gc_mark_done() {
  * 再单独的线程中执行
  * @stack system
  */
+/**
+ * 只有 gc 线程会调用
+ */
+static void gc_pause_record(uint64_t pause_ns) {
+    gc_stats.pause_count += 1;
+    gc_stats.pause_total_ns += pause_ns;
+    gc_stats.last_pause_ns = pause_ns;
+    if ((int64_t) pause_ns > gc_stats.pause_max_ns) {
+        gc_stats.pause_max_ns = pause_ns;
+    }
+
+    uint64_t us = pause_ns / 1000;
+    int index = us == 0 ? 0 : 64 - __builtin_clzll(us);
+    if (index >= GC_PAUSE_HIST_COUNT) {
+        index = GC_PAUSE_HIST_COUNT - 1;
+    }
+    gc_stats.hist[index] += 1;
+}
+
+void runtime_gc_stats(gc_stats_t *out) {
+    assert(out);
+    *out = gc_stats;
+}
+
 void runtime_gc() {
     uint64_t before = allocated_bytes;
 
+    // 上一轮 sweep 保留了 gcmark_bits, 本轮只需要标记 young obj
+    bool minor = memory->mheap->sticky_mark;
+
     // - gc stage: GC_START
     gc_stage = GC_STAGE_START;
     DEBUGF("[runtime_gc] start, allocated=%ldKB, gc stage: GC_START, pid %d", allocated_bytes / 1000, getpid());
@@ -1004,6 +1177,7 @@ void runtime_gc() {
     memory->gc_count += 1;
 
     // 等待所有的 processor 进入安全点
+    uint64_t stw_start = uv_hrtime();
     processor_all_need_stop();
     if (!processor_all_wait_safe(GC_STW_WAIT_COUNT)) {
         DEBUGF("[runtime_gc] wait processor safe timeout, will return")
@@ -1033,8 +1207,15 @@ void runtime_gc() {
 
     scan_pool();
 
+    if (minor) {
+        gc_stats.card_count += scan_cards();
+    } else if (gc_generational) {
+        clear_cards();
+    }
+
     DEBUGF("[runtime_gc] gc work coroutine injected, will start the world");
     processor_all_start();
+    gc_pause_record(uv_hrtime() - stw_start);
 
     // - gc stage: GC_MARK
     gc_stage = GC_STAGE_MARK;
@@ -1045,6 +1226,7 @@ void runtime_gc() {
 
     // STW 之后再更改 GC 阶段
     DEBUGF("[runtime_gc] wait all processor gc work completed, will stop the world and get solo stw locker");
+    stw_start = uv_hrtime();
     processor_all_need_stop();
     if (!processor_all_wait_safe(GC_STW_SWEEP_COUNT)) {
         DEBUGF("[runtime_gc] wait processor safe sweep timeout, will return")
@@ -1067,24 +1249,41 @@ void runtime_gc() {
     gc_stage = GC_STAGE_SWEEP;
     DEBUGF("[runtime_gc] gc stage: GC_SWEEP");
 
-    // gc 清理 需要获取 memory_locker, 避免 wait_sysmon 中 processor_free 产生新的 uncache_span
+    // stw 期间只做与 heap 大小无关的工作: flush mcache, 将所有 span 标记为 unswept, 真正的清理在 start the world 之后进行
     // 此时已经 stw 了，所以不需要使用 memory->locker
     flush_mcache();
     DEBUGF("[runtime_gc] gc flush mcache completed");
 
-    mcentral_sweep(memory->mheap);
-
     flush_pool();
 
-    DEBUGF("[runtime_gc] mcentral_sweep completed, unlock success");
-    // 更新 gcbits
+    // 上一轮的 sweep 已经在 gc_stage = GC_STAGE_OFF 之前完成, 可以更新 gcbits
     gcbits_arenas_epoch();
-    DEBUGF("[runtime_gc] gcbits_arenas_epoch completed, will stop gc barrier");
+    DEBUGF("[runtime_gc] gcbits_arenas_epoch completed");
+
+    mcentral_sweep_prepare(memory->mheap, gen_next_minor(minor));
+    DEBUGF("[runtime_gc] sweep prepare completed, sweepgen=%u, will stop gc barrier", memory->mheap->sweepgen);
 
     gc_barrier_stop();
     processor_all_start();
+    gc_pause_record(uv_hrtime() - stw_start);
 
     // -------------- STW end ----------------------------
+    // 后台 sweep, mutator 在 cache_span 中同样会按需清理 span
+    uint64_t sweep_start = uv_hrtime();
+    mcentral_sweep(memory->mheap);
+    gc_stats.last_sweep_ns = uv_hrtime() - sweep_start;
+    gc_stats.sweep_total_ns += gc_stats.last_sweep_ns;
+    gc_stats.gc_count += 1;
+    if (minor) {
+        gc_stats.minor_count += 1;
+    }
+    DEBUGF("[runtime_gc] mcentral_sweep completed, minor=%d, sweep_ns=%ld", minor, gc_stats.last_sweep_ns);
+
+    gen_last_live = allocated_bytes;
+    if (!minor) {
+        gen_full_live = allocated_bytes;
+    }
+
     // 更新 next gc byts
     int64_t heap_live = allocated_bytes;
     if (heap_live < MIN_GC_BYTES) {
@@ -10,6 +10,7 @@ atomic_size_t allocated_bytes = 0; // 当前分配的内存空间
 
 uint64_t next_gc_bytes = 0; // 下一次 gc 的内存量
 bool gc_barrier; // gc 屏障开启标识
+bool gc_generational = false;
 
 struct sc_map_sv const_str_pool;
 mutex_t const_str_pool_locker;
@@ -17,6 +18,8 @@ mutex_t const_str_pool_locker;
 uint8_t gc_stage; // gc 阶段
 mutex_t gc_stage_locker;
 
+gc_stats_t gc_stats = {0};
+
 memory_t *memory = NULL;
 
 void callers_deserialize() {
@@ -21,12 +21,35 @@ extern uint64_t allocated_total_bytes; // 当前分配的总空间
 extern atomic_size_t allocated_bytes; // 当前分配的内存空间
 extern uint64_t next_gc_bytes; // 下一次 gc 的内存量
 extern bool gc_barrier; // gc 屏障开启标识
+extern bool gc_generational; // 分代模式, 由 NATURE_GC_MODE=generational 开启
 extern struct sc_map_sv const_str_pool;
 extern mutex_t const_str_pool_locker;
 
 extern uint8_t gc_stage; // gc 阶段
 extern mutex_t gc_stage_locker;
 
+#define GC_PAUSE_HIST_COUNT 24
+
+/**
+ * stw 暂停时间统计, 只有 gc 线程会写入
+ * hist[0] 统计小于 1us 的暂停, hist[i] 统计 [2^(i-1), 2^i) us 的暂停, 最后一个 bucket 统计所有更长的暂停
+ * 与 std/runtime gc_stats_t 的内存布局保持一致
+ */
+typedef struct {
+    int64_t gc_count;
+    int64_t pause_count;
+    int64_t pause_total_ns;
+    int64_t pause_max_ns;
+    int64_t last_pause_ns;
+    int64_t sweep_total_ns; // 后台 sweep 耗时, 不包含 stw
+    int64_t last_sweep_ns;
+    int64_t hist[GC_PAUSE_HIST_COUNT];
+    int64_t minor_count; // gc_count 中 minor gc 的次数
+    int64_t card_count; // minor gc 扫描过的 dirty card 总数
+} gc_stats_t;
+
+extern gc_stats_t gc_stats;
+
 typedef enum {
     GC_STAGE_OFF, // 0 表示 gc 关闭, 这也是一个初始状态
     GC_STAGE_START,
@@ -82,6 +105,39 @@ static inline void gc_barrier_stop() {
     gc_barrier = false;
 }
 
+/**
+ * 分代模式下 old obj 的 gcmark_bits 会保留到下一轮 gc, minor gc 不会再次扫描 old obj,
+ * 所以向 old obj 中写入指针时需要标记 slot 所在的 card, minor gc 开始时 dirty card 中的 old obj 作为 root
+ * young obj 没有被标记, 会在下一轮 gc 中被完整扫描, 不需要标记 card
+ */
+static inline void card_mark(addr_t slot) {
+    if (!gc_generational || !(slot >= ARENA_HINT_BASE && slot < memory->mheap->current_arena.end)) {
+        return;
+    }
+
+    arena_t *arena = memory->mheap->arenas[(slot - ARENA_BASE_OFFSET) / ARENA_SIZE];
+    if (!arena) {
+        return;
+    }
+
+    mspan_t *span = arena->spans[(slot - arena->base) / ALLOC_PAGE_SIZE];
+    if (!span || !bitmap_test(span->gcmark_bits, (slot - span->base) / span->obj_size)) {
+        return;
+    }
+
+    arena->cards[(slot - arena->base) >> CARD_SHIFT] = 1;
+}
+
+static inline void card_mark_range(addr_t start, uint64_t size) {
+    if (!gc_generational || size == 0) {
+        return;
+    }
+
+    for (addr_t slot = start; slot < start + size; slot = (slot & ~((addr_t) CARD_SIZE - 1)) + CARD_SIZE) {
+        card_mark(slot);
+    }
+}
+
 /**
  * 最后一位如果为 1 表示 no ptr, 0 表示 has ptr
  * @param spanclass
@@ -182,6 +238,8 @@ bool spanclass_has_ptr(uint8_t spanclass);
 
 void uncache_span(mcentral_t *mcentral, mspan_t *span);
 
+bool mcentral_sweep_one(mcentral_t *central, mspan_t **live);
+
 void mheap_free_span(mheap_t *mheap, mspan_t *span);
 
 
@@ -234,6 +292,8 @@ void *gc_malloc_size(uint64_t size);
 
 uint64_t runtime_malloc_bytes();
 
+void runtime_gc_stats(gc_stats_t *out);
+
 mspan_t *mspan_new(addr_t base, uint64_t pages_count, uint8_t spanclass);
 
 arena_hint_t *arena_hints_init();
@@ -65,7 +65,7 @@ static void sleep_timer_cb(uv_timer_t *timer) {
 
 static inline void uv_async_sleep_register(coroutine_t *co, int64_t ms) {
     uv_timer_t *timer = NEW(uv_timer_t);
-    uv_timer_init(&global_loop, timer);
+    uv_timer_init(processor_loop(), timer);
     timer->data = co;
 
     uv_timer_start(timer, sleep_timer_cb, ms, 0);
@@ -80,7 +80,7 @@ void rt_coroutine_sleep(int64_t ms) {
     DEBUGF("[runtime.rt_coroutine_sleep] start, co=%p p_index=%d, timer=%p, timer_value=%lu", co,
            p->index, &timer, fetch_addr_value((addr_t) &timer));
 
-    global_waiting_send(uv_async_sleep_register, co, (void *) ms, 0);
+    loop_waiting_send(processor_loop(), uv_async_sleep_register, co, (void *) ms, 0);
 
     DEBUGF(
             "[runtime.rt_coroutine_sleep] coroutine sleep resume, co=%p, co_status=%d, p_index=%d, timer=%p",
@@ -54,7 +54,7 @@ void uv_async_getaddrinfo_register(uv_getaddrinfo_t *req, dns_ctx_t *ctx) {
     hints.ai_family = AF_UNSPEC; // IPv4 or IPv6
     hints.ai_socktype = SOCK_STREAM; // TCP
 
-    int result = uv_getaddrinfo(&global_loop, req, on_dns_resolved_cb, rt_string_ref(&ctx->host), NULL, &hints);
+    int result = uv_getaddrinfo(processor_loop(), req, on_dns_resolved_cb, rt_string_ref(&ctx->host), NULL, &hints);
     if (result) {
         DEBUGF("[uv_async_getaddrinfo_register] uv_getaddrinfo failed: %s, co=%p", uv_strerror(result), req->data);
         rti_co_throw(req->data, tlsprintf("resolve %s failed: %s", rt_string_ref(&ctx->host), uv_strerror(result)), false);
@@ -77,7 +77,7 @@ n_vec_t rt_uv_dns_lookup(n_string_t host) {
     req->data = co;
     co->data = ctx;
 
-    global_waiting_send(uv_async_getaddrinfo_register, req, ctx, 0);
+    loop_waiting_send(processor_loop(), uv_async_getaddrinfo_register, req, ctx, 0);
     free(req);
 
     n_vec_t result = ctx->ips;
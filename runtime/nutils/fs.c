@@ -165,7 +165,7 @@ static void uv_async_fs_open(fs_context_t *ctx, char *path) {
     }
     co_ready(ctx->req.data);
 #else
-    int result = uv_fs_open(&global_loop, &ctx->req, path, (int) ctx->flags,
+    int result = uv_fs_open(processor_loop(), &ctx->req, path, (int) ctx->flags,
                             (int) ctx->mode, on_open_cb);
     if (result) {
         rti_co_throw(ctx->req.data, (char *) uv_strerror(result), false);
@@ -183,7 +183,7 @@ fs_context_t *rt_uv_fs_open(n_string_t path, int64_t flags, int64_t mode) {
     ctx->mode = mode;
     ctx->req.data = co;
 
-    global_waiting_send(uv_async_fs_open, ctx, rt_string_ref(&path), 0);
+    loop_waiting_send(processor_loop(), uv_async_fs_open, ctx, rt_string_ref(&path), 0);
     if (co->has_error) {
         n_string_t msg = rti_error_msg(&co->error);
         DEBUGF("[fs_open] open file failed: %s", (char *) rt_string_ref(&msg));
@@ -200,7 +200,7 @@ n_int_t rt_uv_fs_read(fs_context_t *ctx, n_vec_t buf) {
 }
 
 static void uv_async_fs_read_at(fs_context_t *ctx, int offset) {
-    uv_fs_read(&global_loop, &ctx->req, ctx->fd, &ctx->buf, 1, offset, on_read_cb);
+    uv_fs_read(processor_loop(), &ctx->req, ctx->fd, &ctx->buf, 1, offset, on_read_cb);
 }
 
 n_int_t rt_uv_fs_read_at(fs_context_t *ctx, n_vec_t buf, int offset) {
@@ -222,7 +222,7 @@ n_int_t rt_uv_fs_read_at(fs_context_t *ctx, n_vec_t buf, int offset) {
     ctx->offset = offset; // 保存 offset 用于 fallback
 
     // 基于 fd offset 进行读取
-    global_waiting_send(uv_async_fs_read_at, ctx, (void *) offset, 0);
+    loop_waiting_send(processor_loop(), uv_async_fs_read_at, ctx, (void *) offset, 0);
 
     if (co->has_error) {
         n_string_t msg = rti_error_msg(&co->error);
@@ -242,7 +242,7 @@ static void uv_async_fs_write_at(fs_context_t *ctx, n_vec_t *buf, int offset) {
     ctx->offset = offset; // 保存 offset 用于 fallback
 
     // 发起异步写入请求，指定偏移量
-    uv_fs_write(&global_loop, &ctx->req, ctx->fd, &ctx->buf, 1, offset, on_write_cb);
+    uv_fs_write(processor_loop(), &ctx->req, ctx->fd, &ctx->buf, 1, offset, on_write_cb);
 }
 
 n_int_t rt_uv_fs_write_at(fs_context_t *ctx, n_vec_t buf, int offset) {
@@ -257,7 +257,7 @@ n_int_t rt_uv_fs_write_at(fs_context_t *ctx, n_vec_t buf, int offset) {
     DEBUGF("[fs_write_at] write file: %ld, offset: %d, data_len: %ld", ctx->fd, offset, buf.length);
     ctx->req.data = co;
 
-    global_waiting_send(uv_async_fs_write_at, ctx, &buf, (void *) (int64_t) offset);
+    loop_waiting_send(processor_loop(), uv_async_fs_write_at, ctx, &buf, (void *) (int64_t) offset);
 
     if (co->has_error) {
         n_string_t msg = rti_error_msg(&co->error);
@@ -276,7 +276,7 @@ n_int_t rt_uv_fs_write(fs_context_t *ctx, n_vec_t buf) {
 
 static void uv_async_fs_close(fs_context_t *ctx, coroutine_t *co) {
     // 同步方式关闭文件
-    int result = uv_fs_close(&global_loop, &ctx->req, ctx->fd, NULL);
+    int result = uv_fs_close(processor_loop(), &ctx->req, ctx->fd, NULL);
     if (result < 0) {
         DEBUGF("[fs_close] close file failed: %s", uv_strerror(result));
     } else {
@@ -297,7 +297,7 @@ void rt_uv_fs_close(fs_context_t *ctx) {
     }
     ctx->closed = true;
 
-    global_waiting_send(uv_async_fs_close, ctx, coroutine_get(), 0);
+    loop_waiting_send(processor_loop(), uv_async_fs_close, ctx, coroutine_get(), 0);
 }
 
 
@@ -323,7 +323,7 @@ static void on_stat_cb(uv_fs_t *req) {
 
 static void uv_async_fs_stat(fs_context_t *ctx, coroutine_t *co) {
     // Initiate async stat request
-    int result = uv_fs_fstat(&global_loop, &ctx->req, ctx->fd, on_stat_cb);
+    int result = uv_fs_fstat(processor_loop(), &ctx->req, ctx->fd, on_stat_cb);
     if (result < 0) {
         rti_co_throw(co, (char *) uv_strerror(result), false);
         co_ready(co);
@@ -345,7 +345,7 @@ uv_stat_t rt_uv_fs_stat(fs_context_t *ctx) {
     // Set up coroutine resume point
     ctx->req.data = co;
 
-    global_waiting_send(uv_async_fs_stat, ctx, co, 0);
+    loop_waiting_send(processor_loop(), uv_async_fs_stat, ctx, co, 0);
 
     if (co->has_error) {
         n_string_t msg = rti_error_msg(&co->error);
@@ -0,0 +1,276 @@
+#include "hash.h"
+
+/**
+ * flat 表示 key 的全部字节都是有效数据(没有 padding, 也没有 string 这种需要按内容比较的字段),
+ * 此时可以直接按照 storage_size 对整块内存进行 hash 与比较
+ */
+static bool rtype_key_flat(rtype_t *rtype) {
+    uint8_t kind = rtype_key_kind(rtype);
+    return kind == KEY_KIND_INT8 || kind == KEY_KIND_INT16 || kind == KEY_KIND_INT32 || kind == KEY_KIND_INT64 ||
+           kind == KEY_KIND_FLAT;
+}
+
+static uint8_t rtype_key_kind_struct(rtype_t *rtype) {
+    if (rtype->length == 0 || rtype->hashes_offset < 0) {
+        return KEY_KIND_FLAT;
+    }
+
+    rtype_field_t *fields = (rtype_field_t *) RTDATA(rtype->hashes_offset);
+    uint64_t offset = 0;
+    for (int i = 0; i < rtype->length; ++i) {
+        rtype_t *field_rtype = rt_find_rtype(fields[i].hash);
+        assertf(field_rtype, "cannot find struct field rtype by hash=%ld", fields[i].hash);
+
+        if (fields[i].offset != offset || !rtype_key_flat(field_rtype)) {
+            return KEY_KIND_STRUCT;
+        }
+
+        offset += field_rtype->storage_size;
+    }
+
+    // 尾部 padding
+    if (offset != rtype->storage_size) {
+        return KEY_KIND_STRUCT;
+    }
+
+    return KEY_KIND_FLAT;
+}
+
+static uint8_t rtype_key_kind_arr(rtype_t *rtype) {
+    if (rtype->length == 0 || rtype->hashes_offset < 0) {
+        return KEY_KIND_FLAT;
+    }
+
+    int64_t element_hash = ((int64_t *) RTDATA(rtype->hashes_offset))[0];
+    rtype_t *element_rtype = rt_find_rtype(element_hash);
+    assertf(element_rtype, "cannot find arr element rtype by hash=%ld", element_hash);
+
+    return rtype_key_flat(element_rtype) ? KEY_KIND_FLAT : KEY_KIND_ARR;
+}
+
+/**
+ * 与编译器 type_alignof 保持一致, rtype 中没有记录 align, 所以需要根据 rtype 递归计算
+ */
+static uint64_t rtype_key_align(rtype_t *rtype) {
+    if (rtype->storage_kind != STORAGE_KIND_IND) {
+        return rtype->storage_size < POINTER_SIZE ? rtype->storage_size : POINTER_SIZE;
+    }
+
+    if (rtype->kind == TYPE_STRUCT || rtype->kind == TYPE_TUPLE) {
+        uint64_t max_align = 1;
+        for (int i = 0; i < rtype->length; ++i) {
+            int64_t hash = rtype->kind == TYPE_STRUCT ? ((rtype_field_t *) RTDATA(rtype->hashes_offset))[i].hash
+                                                      : ((int64_t *) RTDATA(rtype->hashes_offset))[i];
+            uint64_t align = rtype_key_align(rt_find_rtype(hash));
+            if (align > max_align) {
+                max_align = align;
+            }
+        }
+        return max_align;
+    }
+
+    if (rtype->kind == TYPE_ARR && rtype->hashes_offset >= 0) {
+        return rtype_key_align(rt_find_rtype(((int64_t *) RTDATA(rtype->hashes_offset))[0]));
+    }
+
+    return POINTER_SIZE;
+}
+
+/**
+ * tuple rtype 中只记录了元素的 hash, 元素的 offset 需要按照对齐规则依次计算(参考 rtype_tuple)
+ */
+static rtype_t *rtype_tuple_element(rtype_t *rtype, int index, uint64_t *offset) {
+    rtype_t *element_rtype = rt_find_rtype(((int64_t *) RTDATA(rtype->hashes_offset))[index]);
+    assertf(element_rtype, "cannot find tuple element rtype, index=%d", index);
+
+    *offset = align_up(*offset, rtype_key_align(element_rtype));
+    return element_rtype;
+}
+
+static uint8_t rtype_key_kind_tuple(rtype_t *rtype) {
+    uint64_t offset = 0;
+    uint64_t expect = 0;
+    for (int i = 0; i < rtype->length; ++i) {
+        rtype_t *element_rtype = rtype_tuple_element(rtype, i, &offset);
+        if (offset != expect || !rtype_key_flat(element_rtype)) {
+            return KEY_KIND_TUPLE;
+        }
+
+        offset += element_rtype->storage_size;
+        expect = offset;
+    }
+
+    // 尾部 padding
+    if (offset != rtype->storage_size) {
+        return KEY_KIND_TUPLE;
+    }
+
+    return KEY_KIND_FLAT;
+}
+
+uint8_t rtype_key_kind_resolve(rtype_t *rtype) {
+    assert(rtype);
+
+    if (rtype->kind == TYPE_STRING) {
+        return KEY_KIND_STRING;
+    }
+
+    // union/any 的 value 类型只有运行时才能确定
+    if (rtype->kind == TYPE_UNION) {
+        return KEY_KIND_UNION;
+    }
+
+    if (rtype->kind == TYPE_ANY) {
+        return KEY_KIND_ANY;
+    }
+
+    if (rtype->storage_kind != STORAGE_KIND_IND) {
+        switch (rtype->storage_size) {
+            case 1:
+                return KEY_KIND_INT8;
+            case 2:
+                return KEY_KIND_INT16;
+            case 4:
+                return KEY_KIND_INT32;
+            case 8:
+                return KEY_KIND_INT64;
+            default:
+                return KEY_KIND_FLAT;
+        }
+    }
+
+    if (rtype->kind == TYPE_STRUCT) {
+        return rtype_key_kind_struct(rtype);
+    }
+
+    if (rtype->kind == TYPE_ARR) {
+        return rtype_key_kind_arr(rtype);
+    }
+
+    if (rtype->kind == TYPE_TUPLE) {
+        return rtype_key_kind_tuple(rtype);
+    }
+
+    return KEY_KIND_FLAT;
+}
+
+/**
+ * 返回 union/any 中实际存储的 value 的地址, value_rtype 为 null 表示没有存储任何值
+ */
+static void *key_dynamic_value(uint8_t kind, void *key_ref, rtype_t **value_rtype) {
+    n_any_t *value = key_ref; // n_union_t 与 n_any_t 的 rtype 与 value 的 offset 一致
+    *value_rtype = value->rtype;
+    if (!value->rtype) {
+        return NULL;
+    }
+
+    if (kind == KEY_KIND_ANY && value->rtype->storage_kind == STORAGE_KIND_IND) {
+        return value->value.ptr_value;
+    }
+
+    return &value->value;
+}
+
+uint64_t key_hash_slow(rtype_t *rtype, void *key_ref, uint64_t seed) {
+    uint8_t kind = rtype_key_kind(rtype);
+    uint64_t h = seed;
+
+    if (kind == KEY_KIND_STRUCT) {
+        rtype_field_t *fields = (rtype_field_t *) RTDATA(rtype->hashes_offset);
+        for (int i = 0; i < rtype->length; ++i) {
+            rtype_t *field_rtype = rt_find_rtype(fields[i].hash);
+            uint64_t field_hash = key_hash(field_rtype, key_ref + fields[i].offset);
+            h = key_hash_mix(h ^ field_hash);
+        }
+        return h;
+    }
+
+    if (kind == KEY_KIND_ARR) {
+        rtype_t *element_rtype = rt_find_rtype(((int64_t *) RTDATA(rtype->hashes_offset))[0]);
+        for (int i = 0; i < rtype->length; ++i) {
+            uint64_t element_hash = key_hash(element_rtype, key_ref + i * element_rtype->storage_size);
+            h = key_hash_mix(h ^ element_hash);
+        }
+        return h;
+    }
+
+    if (kind == KEY_KIND_TUPLE) {
+        uint64_t offset = 0;
+        for (int i = 0; i < rtype->length; ++i) {
+            rtype_t *element_rtype = rtype_tuple_element(rtype, i, &offset);
+            uint64_t element_hash = key_hash(element_rtype, key_ref + offset);
+            h = key_hash_mix(h ^ element_hash);
+            offset += element_rtype->storage_size;
+        }
+        return h;
+    }
+
+    if (kind == KEY_KIND_UNION || kind == KEY_KIND_ANY) {
+        rtype_t *value_rtype;
+        void *value_ref = key_dynamic_value(kind, key_ref, &value_rtype);
+        if (!value_rtype) {
+            return key_hash_mix(h);
+        }
+
+        // 不同类型的相同字节需要区分
+        return key_hash_mix(h ^ value_rtype->hash ^ key_hash(value_rtype, value_ref));
+    }
+
+    return key_hash_kind(rtype, kind, key_ref);
+}
+
+bool key_equal_slow(rtype_t *rtype, void *actual, void *expect) {
+    uint8_t kind = rtype_key_kind(rtype);
+
+    if (kind == KEY_KIND_STRUCT) {
+        rtype_field_t *fields = (rtype_field_t *) RTDATA(rtype->hashes_offset);
+        for (int i = 0; i < rtype->length; ++i) {
+            rtype_t *field_rtype = rt_find_rtype(fields[i].hash);
+            if (!key_equal(field_rtype, actual + fields[i].offset, expect + fields[i].offset)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (kind == KEY_KIND_ARR) {
+        rtype_t *element_rtype = rt_find_rtype(((int64_t *) RTDATA(rtype->hashes_offset))[0]);
+        for (int i = 0; i < rtype->length; ++i) {
+            uint64_t offset = i * element_rtype->storage_size;
+            if (!key_equal(element_rtype, actual + offset, expect + offset)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (kind == KEY_KIND_TUPLE) {
+        uint64_t offset = 0;
+        for (int i = 0; i < rtype->length; ++i) {
+            rtype_t *element_rtype = rtype_tuple_element(rtype, i, &offset);
+            if (!key_equal(element_rtype, actual + offset, expect + offset)) {
+                return false;
+            }
+            offset += element_rtype->storage_size;
+        }
+        return true;
+    }
+
+    if (kind == KEY_KIND_UNION || kind == KEY_KIND_ANY) {
+        rtype_t *actual_rtype;
+        rtype_t *expect_rtype;
+        void *actual_value = key_dynamic_value(kind, actual, &actual_rtype);
+        void *expect_value = key_dynamic_value(kind, expect, &expect_rtype);
+        if (!actual_rtype || !expect_rtype) {
+            return actual_rtype == expect_rtype;
+        }
+
+        if (actual_rtype->hash != expect_rtype->hash) {
+            return false;
+        }
+
+        return key_equal(actual_rtype, actual_value, expect_value);
+    }
+
+    return key_equal_kind(rtype, kind, actual, expect);
+}
@@ -40,21 +40,125 @@ static inline uint64_t extract_data_index(uint64_t hash_value) {
     return hash_value << 2 >> 2;
 }
 
+// rtype_t.key_kind, 决定 key 的 hash 与 equal 方式
+#define KEY_KIND_UNKNOWN 0
+#define KEY_KIND_INT8 1 // bool/u8/i8
+#define KEY_KIND_INT16 2
+#define KEY_KIND_INT32 3 // i32/u32/f32
+#define KEY_KIND_INT64 4 // int/f64/ptr/anyptr/enum 等 8byte 直接值
+#define KEY_KIND_STRING 5 // 按照 n_string_t 中的字节内容
+#define KEY_KIND_FLAT 6 // 无 padding 且不包含 string 的 struct/arr, 整块内存 hash 与比较
+#define KEY_KIND_STRUCT 7 // 包含 padding 或 string 的 struct, 逐个 field 递归处理
+#define KEY_KIND_ARR 8 // 元素不是 flat 的 arr, 逐个元素递归处理
+#define KEY_KIND_TUPLE 9 // 包含 padding 或 string 的 tuple, 按照元素对齐计算 offset 后逐个递归处理
+#define KEY_KIND_UNION 10 // 根据存储的 rtype 处理内联在 union 中的 value
+#define KEY_KIND_ANY 11 // 根据存储的 rtype 处理 any value, storage_kind 为 ind 的 value 存储在堆中
+
+#define KEY_HASH_SEED 0x9e3779b97f4a7c15ULL
+
+static inline uint64_t key_hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint64_t key_hash_bytes(uint8_t *data, uint64_t size, uint64_t seed) {
+    uint64_t h = seed ^ (size * KEY_HASH_SEED);
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        h = (h ^ word) * 0x100000001b3ULL;
+        h = (h << 31) | (h >> 33);
+        data += 8;
+        size -= 8;
+    }
+
+    if (size > 0) {
+        uint64_t word = 0;
+        memcpy(&word, data, size);
+        h = (h ^ word) * 0x100000001b3ULL;
+    }
+
+    return key_hash_mix(h);
+}
+
+uint8_t rtype_key_kind_resolve(rtype_t *rtype);
+
+/**
+ * key_kind 在 rtype 首次作为 key 使用时计算并缓存到 rtype 中, 后续的 map/set 操作不再需要分析 rtype
+ * 多个线程同时计算时写入的值相同，所以不需要加锁
+ */
+static inline uint8_t rtype_key_kind(rtype_t *rtype) {
+    uint8_t kind = rtype->key_kind;
+    if (kind != KEY_KIND_UNKNOWN) {
+        return kind;
+    }
+
+    kind = rtype_key_kind_resolve(rtype);
+    rtype->key_kind = kind;
+    return kind;
+}
+
+uint64_t key_hash_slow(rtype_t *rtype, void *key_ref, uint64_t seed);
+
+bool key_equal_slow(rtype_t *rtype, void *actual, void *expect);
+
+static inline uint64_t key_hash_kind(rtype_t *rtype, uint8_t kind, void *key_ref) {
+    switch (kind) {
+        case KEY_KIND_INT8:
+            return key_hash_mix(*(uint8_t *) key_ref ^ KEY_HASH_SEED);
+        case KEY_KIND_INT16:
+            return key_hash_mix(*(uint16_t *) key_ref ^ KEY_HASH_SEED);
+        case KEY_KIND_INT32:
+            return key_hash_mix(*(uint32_t *) key_ref ^ KEY_HASH_SEED);
+        case KEY_KIND_INT64:
+            return key_hash_mix(*(uint64_t *) key_ref ^ KEY_HASH_SEED);
+        case KEY_KIND_STRING: {
+            n_string_t *str = key_ref;
+            return key_hash_bytes(str->data, str->length, KEY_HASH_SEED);
+        }
+        case KEY_KIND_FLAT:
+            return key_hash_bytes(key_ref, rtype->storage_size, KEY_HASH_SEED);
+        default:
+            return key_hash_slow(rtype, key_ref, KEY_HASH_SEED);
+    }
+}
+
+static inline bool key_equal_kind(rtype_t *rtype, uint8_t kind, void *actual, void *expect) {
+    switch (kind) {
+        case KEY_KIND_INT8:
+            return *(uint8_t *) actual == *(uint8_t *) expect;
+        case KEY_KIND_INT16:
+            return *(uint16_t *) actual == *(uint16_t *) expect;
+        case KEY_KIND_INT32:
+            return *(uint32_t *) actual == *(uint32_t *) expect;
+        case KEY_KIND_INT64:
+            return *(uint64_t *) actual == *(uint64_t *) expect;
+        case KEY_KIND_STRING: {
+            n_string_t *a = actual;
+            n_string_t *b = expect;
+            if (a->length != b->length) {
+                return false;
+            }
+            return a->length == 0 || memcmp(a->data, b->data, a->length) == 0;
+        }
+        case KEY_KIND_FLAT:
+            return memcmp(actual, expect, rtype->storage_size) == 0;
+        default:
+            return key_equal_slow(rtype, actual, expect);
+    }
+}
+
 static inline uint64_t key_hash(rtype_t *rtype, void *key_ref) {
-    char *str = rtype_value_to_str(rtype, key_ref);
-    uint64_t result = hash_string(str);
-    free((void *) str);
-    return result;
+    return key_hash_kind(rtype, rtype_key_kind(rtype), key_ref);
 }
 
 static inline bool key_equal(rtype_t *rtype, void *actual, void *expect) {
     DEBUGF("[key_equal] actual=%p, expect=%p", actual, expect);
-    char *actual_str = rtype_value_to_str(rtype, actual);
-    char *expect_str = rtype_value_to_str(rtype, expect);
-    bool result = str_equal(actual_str, expect_str);
-    free((void *) actual_str);
-    free((void *) expect_str);
-    return result;
+    return key_equal_kind(rtype, rtype_key_kind(rtype), actual, expect);
 }
 
 /**
@@ -70,7 +174,8 @@ static uint64_t find_hash_slot(uint64_t *hash_table, uint64_t capacity, uint8_t
     TRACEF("[find_hash_slot] key_ref=%p,  key type_kind=%s", key_ref, type_kind_str[key_rtype->kind]);
 
     uint64_t key_size = key_rtype->storage_size;
-    uint64_t hash = key_hash(key_rtype, key_ref);
+    uint8_t key_kind = rtype_key_kind(key_rtype);
+    uint64_t hash = key_hash_kind(key_rtype, key_kind, key_ref);
 
     // - 开放寻址的方式查找
     uint64_t hash_index = hash % capacity;
@@ -111,7 +216,7 @@ static uint64_t find_hash_slot(uint64_t *hash_table, uint64_t capacity, uint8_t
         void *actual_key_ref = key_data + key_index * key_size;
 
         TRACEF("[find_hash_slot] key_rtype=%s, actual_key_ref=%p, key_ref=%p", type_kind_str[key_rtype->kind], actual_key_ref, key_ref);
-        if (key_equal(key_rtype, actual_key_ref, key_ref)) {
+        if (key_equal_kind(key_rtype, key_kind, actual_key_ref, key_ref)) {
             return hash_index;
         }
 
@@ -17,12 +17,12 @@
 #define FREELIST_MAX 10000
 #define FREELIST_MIN 1000
 
-static http_conn_t *acquire_conn(inner_http_server_t *inner) {
-    if (inner->count > 0) {
-        freenode_t *node = inner->freelist;
-        inner->freelist = node->next;
+static http_conn_t *acquire_conn(http_listener_t *listener) {
+    if (listener->count > 0) {
+        freenode_t *node = listener->freelist;
+        listener->freelist = node->next;
         node->next = NULL;
-        inner->count--;
+        listener->count--;
         return (http_conn_t *) node;
     }
 
@@ -30,8 +30,9 @@ static http_conn_t *acquire_conn(inner_http_server_t *inner) {
     return mallocz(sizeof(http_conn_t));
 }
 
-static void release_conn(inner_http_server_t *inner, http_conn_t *conn) {
-    if (inner->count > inner->max) {
+static void release_conn(http_listener_t *listener, http_conn_t *conn) {
+    inner_http_server_t *inner = listener->inner;
+    if (listener->count > inner->max) {
         free(conn);
         return;
     }
@@ -39,37 +40,36 @@ static void release_conn(inner_http_server_t *inner, http_conn_t *conn) {
     memset(conn, 0, sizeof(http_conn_t));
 
     freenode_t *node = (freenode_t *) conn;
-    node->next = inner->freelist;
-    inner->freelist = node;
-    inner->count++;
+    node->next = listener->freelist;
+    listener->freelist = node;
+    listener->count++;
 }
 
-static void init_conn(inner_http_server_t *inner) {
+static void init_conn(http_listener_t *listener) {
+    inner_http_server_t *inner = listener->inner;
     for (int i = 0; i < inner->min; ++i) {
         freenode_t *node = mallocz(sizeof(http_conn_t));
 
-        node->next = inner->freelist;
-        inner->freelist = node;
-        inner->count += 1;
+        node->next = listener->freelist;
+        listener->freelist = node;
+        listener->count += 1;
     }
 }
 
-static void free_conn(inner_http_server_t *inner) {
-    while (inner->freelist) {
-        freenode_t *node = inner->freelist;
-        inner->freelist = node->next;
-        inner->count -= 1;
+static void free_conn(http_listener_t *listener) {
+    while (listener->freelist) {
+        freenode_t *node = listener->freelist;
+        listener->freelist = node->next;
+        listener->count -= 1;
         free(node);
     }
-
-    free(inner);
 }
 
 static inline void on_async_conn_close_cb(uv_handle_t *handle) {
     http_conn_t *conn = CONTAINER_OF(handle, http_conn_t, async_write_handle);
     DEBUGF("[on_async_conn_close_cb] conn: %p", conn);
-    assert(conn->n_server);
-    inner_http_server_t *inner = conn->n_server->inner;
+    assert(conn->listener);
+    http_listener_t *listener = conn->listener;
 
 
     conn->read_buf_len = 0;
@@ -79,8 +79,8 @@ static inline void on_async_conn_close_cb(uv_handle_t *handle) {
         free(conn->write_buf.base);
     }
 
-    conn->n_server->inner->closed_count += 1;
-    release_conn(inner, conn);
+    listener->closed_count += 1;
+    release_conn(listener, conn);
 }
 
 static inline void on_conn_close_cb(uv_handle_t *handle) {
@@ -128,7 +128,7 @@ static inline void on_write_end_cb(uv_write_t *write_req, int status) {
 static inline void http_alloc_buffer_cb(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
     http_conn_t *conn = CONTAINER_OF(handle, http_conn_t, handle);
 
-    conn->n_server->inner->read_alloc_buf_count += 1;
+    conn->listener->read_alloc_buf_count += 1;
 
     DEBUGF("[uv_alloc_buffer] suggested_size: %ld", suggested_size);
     conn->read_buf_cap += HTTP_BUFFER_SIZE;
@@ -154,7 +154,7 @@ static inline void http_alloc_buffer_cb(uv_handle_t *handle, size_t suggested_si
 static inline void async_conn_write_handle_cb(uv_async_t *handle) {
     http_conn_t *conn = CONTAINER_OF(handle, http_conn_t, async_write_handle);
     DEBUGF("[async_conn_write_handle_cb] conn: %p, client_handle: %p", conn, handle);
-    conn->n_server->inner->resp_count += 1;
+    conn->listener->resp_count += 1;
 
     int result = uv_write(&conn->write_req, (uv_stream_t *) &conn->handle, &conn->write_buf, 1, on_write_end_cb);
     if (result) {
@@ -167,10 +167,10 @@ static inline void async_conn_write_handle_cb(uv_async_t *handle) {
 static inline void on_read_cb(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf) {
     DEBUGF("[on_read_cb] client: %p, nread: %ld", handle, nread);
     http_conn_t *conn = CONTAINER_OF(handle, http_conn_t, handle);
-    conn->n_server->inner->read_cb_count += 1;
+    conn->listener->read_cb_count += 1;
 
     if (nread < 0) {
-        conn->n_server->inner->read_error_count += 1;
+        conn->listener->read_error_count += 1;
 
         if (nread == UV_EOF) {
             // do nothing
@@ -201,7 +201,7 @@ static inline void on_read_cb(uv_stream_t *handle, ssize_t nread, const uv_buf_t
 
     uv_read_stop(handle);
 
-    conn->n_server->inner->coroutine_count += 1;
+    conn->listener->coroutine_count += 1;
     coroutine_t *conn_co = rt_coroutine_new(conn->n_server->handler, 0, NULL, conn);
     rt_coroutine_dispatch(conn_co);
 }
@@ -291,7 +291,8 @@ static int http_parser_on_message_complete_cb(llhttp_t *parser) {
  */
 static void on_http_conn_cb(uv_stream_t *server, int status) {
     DEBUGF("[on_http_conn_cb] status: %d", status);
-    inner_http_server_t *inner = CONTAINER_OF(server, inner_http_server_t, handle);
+    http_listener_t *listener = CONTAINER_OF(server, http_listener_t, handle);
+    inner_http_server_t *inner = listener->inner;
     if (status < 0) {
         DEBUGF("[on_http_conn_cb] new connection error: %s", uv_strerror(status));
         return;
@@ -300,20 +301,21 @@ static void on_http_conn_cb(uv_stream_t *server, int status) {
     coroutine_t *listen_co = inner->listen_co;
 
     // 初始化 client 数据 accept loop 和 listen loop 必须使用同一个 loop
-    http_conn_t *conn = acquire_conn(inner);
+    http_conn_t *conn = acquire_conn(listener);
 
     conn->create_time = uv_hrtime();
     conn->n_server = inner->server;
+    conn->listener = listener;
     llhttp_settings_init(&conn->settings);
     conn->settings.on_url = http_parser_on_url_cb;
     conn->settings.on_header_field = http_parser_on_header_field_cb;
     conn->settings.on_header_value = http_parser_on_header_value_cb;
     conn->settings.on_body = http_parser_on_body_cb;
     conn->settings.on_message_complete = http_parser_on_message_complete_cb;
-    uv_async_init(&global_loop, &conn->async_write_handle, async_conn_write_handle_cb);
+    uv_async_init(listener->loop, &conn->async_write_handle, async_conn_write_handle_cb);
     llhttp_init(&conn->parser, HTTP_REQUEST, &conn->settings);
 
-    uv_tcp_init(&global_loop, &conn->handle);
+    uv_tcp_init(listener->loop, &conn->handle);
     int result = uv_accept(server, (uv_stream_t *) &conn->handle);
     if (result) {
         DEBUGF("[on_http_conn_cb] uv_accept failed: %s", uv_strerror(result));
@@ -321,7 +323,7 @@ static void on_http_conn_cb(uv_stream_t *server, int status) {
         return;
     }
 
-    inner->conn_count += 1;
+    listener->conn_count += 1;
     // 直接进行 conn 读取
     conn->handle.data = listen_co;
     result = uv_read_start((uv_stream_t *) &conn->handle, http_alloc_buffer_cb, on_read_cb);
@@ -330,89 +332,187 @@ static void on_http_conn_cb(uv_stream_t *server, int status) {
         http_conn_close(conn);
         return;
     }
-    inner->read_start_count += 1; // 记录成功启动读取的连接
+    listener->read_start_count += 1; // 记录成功启动读取的连接
     DEBUGF("[accept_new_conn] accept new conn and create client co success, conn: %p, client_handle: %p", conn,
            &conn->handle);
-
-    uv_async_send(&global.async_weak);
 }
 
-static inline void on_server_close_cb(uv_handle_t *handle) {
-    inner_http_server_t *inner = CONTAINER_OF(handle, inner_http_server_t, handle);
-    coroutine_t *listen_co = inner->listen_co;
-
-    free_conn(inner);
-    co_ready(listen_co);
+static inline void http_server_unref(inner_http_server_t *inner) {
+    if (atomic_fetch_sub(&inner->refs, 1) == 1) {
+        co_ready(inner->listen_co);
+    }
 }
 
-static void uv_async_http_close(n_http_server_t *server) {
-    uv_close((uv_handle_t *) &server->inner->handle, on_server_close_cb);
+static inline void on_listener_close_cb(uv_handle_t *handle) {
+    http_listener_t *listener = CONTAINER_OF(handle, http_listener_t, handle);
+
+    free_conn(listener);
+    http_server_unref(listener->inner);
 }
 
 void test_timer_dump_count_cb(uv_timer_t *timer) {
-    inner_http_server_t *inner = timer->data;
+    http_listener_t *listener = timer->data;
 
-    int64_t pending_read = inner->read_start_count - inner->read_cb_count;
-    int64_t pending_close = inner->read_cb_count - inner->closed_count;
-    int64_t leaked = inner->conn_count - inner->closed_count;
+    int64_t pending_read = listener->read_start_count - listener->read_cb_count;
+    int64_t pending_close = listener->read_cb_count - listener->closed_count;
+    int64_t leaked = listener->conn_count - listener->closed_count;
 
     DEBUGF("[app_metrics] conn=%ld, read_start=%ld, alloc_cb=%ld, read_cb=%ld, read_error=%ld, "
            "resp=%ld, closed=%ld, "
            "pending_read=%ld, pending_close=%ld, leaked=%ld",
-           inner->conn_count, inner->read_start_count, inner->read_alloc_buf_count, inner->read_cb_count,
-           inner->read_error_count,
-           inner->resp_count, inner->closed_count,
+           listener->conn_count, listener->read_start_count, listener->read_alloc_buf_count, listener->read_cb_count,
+           listener->read_error_count,
+           listener->resp_count, listener->closed_count,
            pending_read, pending_close, leaked);
 }
 
-
-// 由 libuv 通用 async 触发的回调器
-static void uv_async_http_listen(inner_http_server_t *inner) {
-    uv_tcp_init(&global_loop, &inner->handle);
-    inner->handle.data = inner->listen_co;
-    struct sockaddr_in addr;
-
+/**
+ * 在 listener->loop 所属的线程中调用, 失败时 handle 已经初始化, 需要由调用方 close
+ */
+static int http_listener_bind(http_listener_t *listener, unsigned int flags) {
+    inner_http_server_t *inner = listener->inner;
     n_http_server_t *server = inner->server;
+    struct sockaddr_in addr;
 
     // TODO 测试逻辑
     //    uv_timer_t *timer = mallocz(sizeof(uv_timer_t));
-    //    uv_timer_init(&global_loop, timer);
-    //    timer->data = inner;
+    //    uv_timer_init(listener->loop, timer);
+    //    timer->data = listener;
     //    uv_timer_start(timer, test_timer_dump_count_cb, 1000, 1000);
 
     uv_ip4_addr(rt_string_ref(&server->addr), server->port, &addr);
-    uv_tcp_bind(&inner->handle, (const struct sockaddr *) &addr, 0);
+    int result = uv_tcp_bind(&listener->handle, (const struct sockaddr *) &addr, flags);
+    if (result) {
+        return result;
+    }
+
+    result = uv_listen((uv_stream_t *) &listener->handle, DEFAULT_BACKLOG, on_http_conn_cb);
+    if (result) {
+        return result;
+    }
+
+    init_conn(listener);
+    listener->listening = true;
+    return 0;
+}
+
+// 在其他 processor 的 loop 中启动 listener, 失败时只放弃当前 processor, 不影响已经启动的 listener
+static void uv_async_http_listener_start(http_listener_t *listener) {
+    inner_http_server_t *inner = listener->inner;
+    if (atomic_load(&inner->closed)) {
+        http_server_unref(inner);
+        return;
+    }
+
+    uv_tcp_init(listener->loop, &listener->handle);
+    int result = http_listener_bind(listener, UV_TCP_REUSEPORT);
+    if (result) {
+        DEBUGF("[uv_async_http_listener_start] p_index=%d listen failed: %s",
+               ((n_processor_t *) listener->loop->data)->index, uv_strerror(result));
+        uv_close((uv_handle_t *) &listener->handle, on_listener_close_cb);
+    }
+}
+
+static void uv_async_http_listener_close(http_listener_t *listener) {
+    inner_http_server_t *inner = listener->inner;
+    if (listener->listening) {
+        listener->listening = false;
+        uv_close((uv_handle_t *) &listener->handle, on_listener_close_cb);
+    }
+
+    http_server_unref(inner);
+}
+
+// 在 listen coroutine 所在 processor 的 loop 中启动第一个 listener, 成功之后再分发到其他 processor
+static void uv_async_http_listen(inner_http_server_t *inner) {
+    http_listener_t *first = &inner->listeners[0];
+    unsigned int flags = inner->listener_count > 1 ? UV_TCP_REUSEPORT : 0;
+
+    uv_tcp_init(first->loop, &first->handle);
+    first->handle.data = inner->listen_co;
+
+    int result = http_listener_bind(first, flags);
+    if (result == UV_ENOTSUP && flags) {
+        // 当前平台不支持 SO_REUSEPORT, 退化为单个 listener
+        result = http_listener_bind(first, 0);
+        flags = 0;
+    }
 
-    int result = uv_listen((uv_stream_t *) &inner->handle, DEFAULT_BACKLOG, on_http_conn_cb);
     if (result) {
         rti_co_throw(inner->listen_co, tlsprintf("listen failed: %s", uv_strerror(result)), false);
-        co_ready(inner->listen_co);
+        flags = 0;
+
+        // listen 失败之后 close 不会再投递任务, 由这里释放 close 持有的引用
+        if (!atomic_exchange(&inner->closed, true)) {
+            for (int64_t i = 0; i < inner->listener_count; ++i) {
+                http_server_unref(inner);
+            }
+        }
+        uv_close((uv_handle_t *) &first->handle, on_listener_close_cb);
+    }
+
+    for (int64_t i = 1; i < inner->listener_count; ++i) {
+        http_listener_t *listener = &inner->listeners[i];
+        if (!flags) {
+            http_server_unref(inner);
+            continue;
+        }
+
+        processor_wake(listener->loop->data);
+        loop_async_send(listener->loop, uv_async_http_listener_start, listener, 0, 0);
     }
 }
 
 
 void rt_uv_http_close(n_http_server_t *server) {
-    global_async_send(uv_async_http_close, server, 0, 0);
+    inner_http_server_t *inner = server->inner;
+    if (atomic_exchange(&inner->closed, true)) {
+        return;
+    }
+
+    for (int64_t i = 0; i < inner->listener_count; ++i) {
+        http_listener_t *listener = &inner->listeners[i];
+        loop_async_send(listener->loop, uv_async_http_listener_close, listener, 0, 0);
+    }
 }
 
 /**
+ * listen coroutine 会一直 waiting 直到所有 listener 关闭
  * @param server
  */
 void rt_uv_http_listen(n_http_server_t *server) {
     n_processor_t *p = processor_get();
     coroutine_t *co = coroutine_get();
 
-    inner_http_server_t *inner = malloc(sizeof(inner_http_server_t));
-    inner->count = 0;
-    inner->freelist = NULL;
+    inner_http_server_t *inner = mallocz(sizeof(inner_http_server_t));
     inner->max = FREELIST_MAX;
     inner->min = FREELIST_MIN;
-    init_conn(inner);
     inner->listen_co = co;
     inner->server = server;
+
+    // 当前 processor 的 listener 位于首位, 其余 processor 各持有一个
+    inner->listener_count = cpu_count;
+    inner->listeners = mallocz(sizeof(http_listener_t) * cpu_count);
+    inner->listeners[0].loop = processor_loop();
+    for (int i = 0, j = 1; i < cpu_count; ++i) {
+        if (processor_index[i] == co->p) {
+            continue;
+        }
+        inner->listeners[j++].loop = processor_index[i]->uv_loop;
+    }
+    for (int64_t i = 0; i < inner->listener_count; ++i) {
+        inner->listeners[i].inner = inner;
+    }
+    atomic_init(&inner->refs, inner->listener_count * 2);
+    atomic_init(&inner->closed, false);
     server->inner = inner;
 
-    global_waiting_send(uv_async_http_listen, inner, 0, 0);
+    loop_waiting_send(processor_loop(), uv_async_http_listen, inner, 0, 0);
+
+    // 所有 listener 以及 close 任务都已经完成, 不会再有线程访问 inner
+    server->inner = NULL;
+    free(inner->listeners);
+    free(inner);
 
     DEBUGF("[rt_uv_http_listen] listen resume, port=%ld, and return, p_index=%d", server->port, p->index);
 }
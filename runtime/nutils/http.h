@@ -16,14 +16,17 @@ typedef struct {
     void *next;
 } freenode_t;
 
+/**
+ * 每个 processor 持有一个 listener, 通过 SO_REUSEPORT 绑定同一个端口, 由内核将新连接分散到各个 processor 的 loop 中
+ * listener 中的字段只会在所属 loop 的线程中访问
+ */
 typedef struct {
     uv_tcp_t handle;
-    freenode_t *freelist; // 空闲的链接列表？
+    uv_loop_t *loop; // 所属 processor 的 loop
+    void *inner; // inner_http_server_t
+    bool listening;
+    freenode_t *freelist; // 空闲的链接列表
     int count;
-    int max; // 500
-    int min; // 50
-    coroutine_t *listen_co;
-    void *server;
     int64_t conn_count;
     int64_t read_cb_count;
     int64_t closed_count;
@@ -32,6 +35,18 @@ typedef struct {
     int64_t coroutine_count;
     int64_t resp_count;
     int64_t read_start_count; // 记录 uv_read_start 成功的次数
+} http_listener_t;
+
+typedef struct {
+    http_listener_t *listeners;
+    int64_t listener_count;
+    // 每个 listener 持有两个引用: listener 自身的关闭以及 close 任务的执行, 全部释放之后唤醒 listen_co
+    _Atomic int64_t refs;
+    _Atomic bool closed;
+    int max; // 500
+    int min; // 50
+    coroutine_t *listen_co;
+    void *server;
 } inner_http_server_t;
 
 /**
@@ -90,6 +105,7 @@ typedef struct {
     uv_write_t write_req;
     uv_buf_t write_buf;
     int64_t create_time;
+    http_listener_t *listener; // accept 当前连接的 listener, conn 的所有 handle 都位于 listener->loop
 } http_conn_t;
 
 void rt_uv_conn_resp(http_conn_t *conn, n_string_t resp_data);
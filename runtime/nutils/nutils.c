@@ -866,6 +866,10 @@ char *rtype_value_to_str(rtype_t *rtype, void *data_ref) {
 // mark_black_new_obj 如果 new_obj 不是从 allocator(gc_malloc) 获取的新对象，则有必要主动 mark black 避免其被 sweep
 void rti_write_barrier_ptr(void *slot, void *new_obj, bool mark_black_new_obj) {
     DEBUGF("[rt_write_barrier_ptr] slot=%p, new_obj=%p, barrier_ptr?=%d", slot, new_obj, gc_barrier_get());
+    if (new_obj) {
+        card_mark((addr_t) slot);
+    }
+
     if (!gc_barrier_get()) {
         *(void **) slot = new_obj;
         return;
@@ -900,10 +904,36 @@ void write_barrier(void *slot, void *new_obj) {
     rti_write_barrier_ptr(slot, new_obj, false);
 }
 
+/**
+ * string/vec/struct 等包含指针的值通过 memmove 整体写入 dst 之后调用, dst 可能位于栈中
+ * mark 阶段不逐个处理 slot, 而是将 dst 所在的 obj 重新置灰, 再次扫描时就能够标记本次写入的指针
+ */
+void rti_write_barrier_range(void *dst, uint64_t size) {
+    addr_t addr = (addr_t) dst;
+    if (!in_heap(addr)) {
+        return;
+    }
+
+    card_mark_range(addr, size);
+
+    if (gc_barrier_get() && span_of(addr)) {
+        shade_obj_grey(dst);
+    }
+}
+
+void write_barrier_range(void *dst, int64_t size) {
+    rti_write_barrier_range(dst, size);
+}
+
 void rti_write_barrier_rtype(void *dst, void *src, rtype_t *rtype) {
     memmove(dst, src, rtype->storage_size);
 
-    if (!gc_barrier_get() || rtype->last_ptr == 0) {
+    if (rtype->last_ptr == 0) {
+        return;
+    }
+
+    card_mark_range((addr_t) dst, rtype->storage_size);
+    if (!gc_barrier_get()) {
         return;
     }
 
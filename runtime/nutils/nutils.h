@@ -69,8 +69,12 @@ void rti_write_barrier_ptr(void *slot, void *new_obj, bool mark_black_new_obj);
 
 void rti_write_barrier_rtype(void *dst, void *src, rtype_t *rtype);
 
+void rti_write_barrier_range(void *dst, uint64_t size);
+
 void write_barrier(void *slot, void *new_obj);
 
+void write_barrier_range(void *dst, int64_t size);
+
 void ptr_valid(void *ptr);
 
 void rt_panic(n_string_t msg);
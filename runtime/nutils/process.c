@@ -141,9 +141,9 @@ static inline void on_read_stdout_cb(uv_stream_t *stream, ssize_t nread, const u
 
 static void uv_async_process_spawn(process_context_t *ctx, coroutine_t *co) {
     // 初始化
-    uv_pipe_init(&global_loop, &ctx->stdin_pipe.pipe, 0);
-    uv_pipe_init(&global_loop, &ctx->stderr_pipe.pipe, 0);
-    uv_pipe_init(&global_loop, &ctx->stdout_pipe.pipe, 0);
+    uv_pipe_init(ctx->p->uv_loop, &ctx->stdin_pipe.pipe, 0);
+    uv_pipe_init(ctx->p->uv_loop, &ctx->stderr_pipe.pipe, 0);
+    uv_pipe_init(ctx->p->uv_loop, &ctx->stdout_pipe.pipe, 0);
 
     uv_process_options_t options = {0};
     options.exit_cb = on_exit_cb;
@@ -164,7 +164,7 @@ static void uv_async_process_spawn(process_context_t *ctx, coroutine_t *co) {
     options.stdio = stdio;
     options.stdio_count = 3;
 
-    int result = uv_spawn(&global_loop, &ctx->req, &options);
+    int result = uv_spawn(ctx->p->uv_loop, &ctx->req, &options);
     if (result) {
         close_pipe(&ctx->stdin_pipe);
         close_pipe(&ctx->stdout_pipe);
@@ -225,7 +225,7 @@ process_context_t *rt_uv_process_spawn(command_t *cmd) {
         ctx->envs[cmd->env.length] = NULL;
     }
 
-    global_waiting_send(uv_async_process_spawn, ctx, co, 0);
+    loop_waiting_send(ctx->p->uv_loop, uv_async_process_spawn, ctx, co, 0);
 
     DEBUGF("[rt_uv_process_spawn] end, ctx: %p", ctx)
     return ctx;
@@ -273,7 +273,7 @@ n_int_t rt_uv_process_write_stdin(process_context_t *ctx, n_vec_t buf) {
     memcpy(ctx->stdin_pipe.buffer, buf.data, buf.length);
     ctx->stdin_pipe.buffer_count = buf.length;
     ctx->stdin_pipe.pipe.data = co;
-    global_waiting_send(uv_async_process_write_stdin, ctx, 0, 0);
+    loop_waiting_send(ctx->p->uv_loop, uv_async_process_write_stdin, ctx, 0, 0);
 
     if (co->has_error) {
         return 0;
@@ -287,7 +287,7 @@ void rt_uv_process_close_stdin(process_context_t *ctx) {
     }
 
     ctx->stdin_pipe.closed = true;
-    global_async_send(close_pipe, &ctx->stdin_pipe, 0, 0);
+    loop_async_send(ctx->p->uv_loop, close_pipe, &ctx->stdin_pipe, 0, 0);
 }
 
 void uv_async_process_wait(process_context_t *ctx, coroutine_t *co) {
@@ -304,14 +304,14 @@ void uv_async_process_wait(process_context_t *ctx, coroutine_t *co) {
 }
 
 /**
- * uv_loop 和当前 coroutine 必须在同一个 processor 中运行, 基于此可以避免 race 问题，判断 exited 也不需要加锁。
+ * uv_async_process_wait 与 on_exit_cb 都运行在 ctx->p 的 loop 线程中, 基于此可以避免 race 问题，判断 exited 也不需要加锁。
  */
 void rt_uv_process_wait(process_context_t *ctx) {
     assert(ctx);
     n_processor_t *p = processor_get();
     coroutine_t *co = coroutine_get();
 
-    global_waiting_send(uv_async_process_wait, ctx, co, 0);
+    loop_waiting_send(ctx->p->uv_loop, uv_async_process_wait, ctx, co, 0);
 
     DEBUGF("[rt_uv_process_wait] process %ld exited", ctx->pid);
 }
@@ -330,7 +330,7 @@ n_string_t rt_uv_process_read_stdout(process_context_t *ctx) {
     }
 
     ctx->stdout_pipe.pipe.data = co;
-    global_waiting_send(uv_async_process_read_stdout, ctx, 0, 0);
+    loop_waiting_send(ctx->p->uv_loop, uv_async_process_read_stdout, ctx, 0, 0);
 
     if (co->has_error) {
         DEBUGF("[rt_uv_process_read_stdout] co has err, will return NULL")
@@ -355,7 +355,7 @@ n_string_t rt_uv_process_read_stderr(process_context_t *ctx) {
     }
 
     ctx->stderr_pipe.pipe.data = co;
-    global_waiting_send(uv_async_process_read_stderr, ctx, 0, 0);
+    loop_waiting_send(ctx->p->uv_loop, uv_async_process_read_stderr, ctx, 0, 0);
 
     if (co->has_error) {
         DEBUGF("[rt_uv_process_read_stderr] co has err, will return NULL")
@@ -258,7 +258,7 @@ int64_t rt_uv_tcp_read(n_tcp_conn_t *n_conn, n_vec_t buf) {
     conn->handle.data = conn;
     conn->buf = buf;
 
-    global_waiting_send(uv_async_tcp_read, conn, 0, 0);
+    loop_waiting_send(conn->handle.loop, uv_async_tcp_read, conn, 0, 0);
     DEBUGF("[rt_uv_tcp_read] co=%p resume completed, read len: %ld", co, conn->read_len);
 
     int64_t read_len = conn->read_len;
@@ -309,7 +309,7 @@ int64_t rt_uv_tcp_write(n_tcp_conn_t *n_conn, n_vec_t buf) {
     conn->handle.data = conn;
     conn->buf = buf;
 
-    global_waiting_send(uv_async_tcp_write, conn, 0, 0);
+    loop_waiting_send(conn->handle.loop, uv_async_tcp_write, conn, 0, 0);
 
     DEBUGF("[rt_uv_tcp_write] co=%p, waiting resume", co)
 
@@ -353,8 +353,8 @@ static inline void on_tcp_timeout_cb(uv_timer_t *handle) {
 
 static void uv_async_tcp_connect(inner_conn_t *conn, struct sockaddr_in *dest, n_int64_t timeout_ms) {
     DEBUGF("[uv_async_tcp_connect] start, timeout_ms=%ld, dest=%p", timeout_ms, dest)
-    uv_tcp_init(&global_loop, &conn->handle);
-    uv_timer_init(&global_loop, &conn->timer);
+    uv_tcp_init(processor_loop(), &conn->handle);
+    uv_timer_init(processor_loop(), &conn->timer);
 
     uv_tcp_connect(&conn->conn_req, &conn->handle, (const struct sockaddr *) dest, on_tcp_connect_cb);
 
@@ -382,7 +382,8 @@ void rt_uv_tcp_connect(n_tcp_conn_t *n_conn, n_string_t ip, n_int64_t port, n_in
     n_conn->conn = conn;
     conn->co = co;
 
-    global_waiting_send(uv_async_tcp_connect, conn, dest, (void *) timeout_ms);
+    // 主动建立的连接绑定在当前 processor 的 loop 上
+    loop_waiting_send(processor_loop(), uv_async_tcp_connect, conn, dest, (void *) timeout_ms);
 
     DEBUGF("[rt_uv_tcp_connect] resume, connect success, will return conn=%p, co=%p", conn, co)
 }
@@ -505,7 +506,7 @@ void on_tcp_conn_cb(uv_stream_t *handle, int status) {
 }
 
 static void uv_async_tcp_listen(n_tcp_server_t *server) {
-    uv_tcp_init(&global_loop, &server->inner->handle);
+    uv_tcp_init(processor_loop(), &server->inner->handle);
     server->inner->handle.data = server->inner;
 
     struct sockaddr_in addr;
@@ -534,7 +535,7 @@ void rt_uv_tcp_listen(n_tcp_server_t *server) {
     co->data = server;
     server->inner->listen_co = co;
 
-    global_waiting_send(uv_async_tcp_listen, server, 0, 0);
+    loop_waiting_send(processor_loop(), uv_async_tcp_listen, server, 0, 0);
 
     init_conn(server->inner);
     DEBUGF("[rt_uv_tcp_listen] listen success, will return")
@@ -550,7 +551,7 @@ void rt_uv_tcp_server_close(n_tcp_server_t *server) {
     }
 
     server->closed = true;
-    global_async_send(uv_async_server_close, server, NULL, NULL);
+    loop_async_send(server->inner->handle.loop, uv_async_server_close, server, NULL, NULL);
 }
 
 void uv_async_conn_close(inner_conn_t *conn) {
@@ -582,7 +583,7 @@ void rt_uv_tcp_conn_close(n_tcp_conn_t *n_conn) {
     inner_conn_t *conn = n_conn->conn;
     coroutine_t *co = coroutine_get();
     conn->co = co;
-    global_waiting_send(uv_async_conn_close, conn, 0, 0);
+    loop_waiting_send(conn->handle.loop, uv_async_conn_close, conn, 0, 0);
 }
 
 #endif //NATURE_RUNTIME_NUTILS_TCP_H_
@@ -161,7 +161,7 @@ static void uv_async_tls_write(inner_tls_conn_t *conn, char *buf, size_t len) {
 static int mbedtls_send_cb(void *ctx, const unsigned char *buf, size_t len) {
     inner_tls_conn_t *conn = (inner_tls_conn_t *) ctx;
 
-    global_waiting_send(uv_async_tls_write, conn, (void *) buf, (void *) len);
+    loop_waiting_send(conn->handle.loop, uv_async_tls_write, conn, (void *) buf, (void *) len);
 
     return len;
 }
@@ -201,7 +201,7 @@ static int mbedtls_recv_cb(void *ctx, unsigned char *buf, size_t len) {
     conn->read_waiting = true;
     conn->read_started = false;
 
-    global_waiting_send(uv_async_tls_read, conn, 0, 0);
+    loop_waiting_send(conn->handle.loop, uv_async_tls_read, conn, 0, 0);
     // may be error
     if (conn->read_timeout) {
         return MBEDTLS_ERR_SSL_TIMEOUT;
@@ -309,8 +309,8 @@ static inline void on_tls_timeout_cb(uv_timer_t *handle) {
 }
 
 static void uv_async_tls_connect(inner_tls_conn_t *conn, struct sockaddr_in *dest, n_int64_t timeout_ms) {
-    uv_tcp_init(&global_loop, &conn->handle);
-    uv_timer_init(&global_loop, &conn->timer);
+    uv_tcp_init(processor_loop(), &conn->handle);
+    uv_timer_init(processor_loop(), &conn->timer);
 
     uv_tcp_connect(&conn->conn_req, &conn->handle, (const struct sockaddr *) dest, on_tls_connect_cb);
 
@@ -369,7 +369,7 @@ void rt_uv_tls_connect(n_tls_conn_t *n_conn, n_string_t addr, n_int64_t port, n_
         return;
     }
 
-    global_waiting_send(uv_async_tls_connect, conn, dest, (void *) timeout_ms);
+    loop_waiting_send(processor_loop(), uv_async_tls_connect, conn, dest, (void *) timeout_ms);
 
     if (conn->timeout || uv_is_closing((uv_handle_t *) &conn->handle)) {
         n_conn->closed = true;
@@ -394,7 +394,7 @@ void rt_uv_tls_connect(n_tls_conn_t *n_conn, n_string_t addr, n_int64_t port, n_
             mbedtls_strerror(ret, error_buf, sizeof(error_buf));
             rti_co_throw(conn->co, tlsprintf("tls handshake failed: %s", error_buf), false);
             n_conn->closed = true;
-            global_async_send(uv_async_conn_close, conn, 0, 0);
+            loop_async_send(conn->handle.loop, uv_async_conn_close, conn, 0, 0);
             tls_release_conn(conn);
             return;
         }
@@ -517,7 +517,7 @@ void rt_uv_tls_conn_close(n_tls_conn_t *n_conn) {
         mbedtls_ssl_close_notify(&conn->ssl);
     }
 
-    global_async_send(uv_async_conn_close, conn, 0, 0);
+    loop_async_send(conn->handle.loop, uv_async_conn_close, conn, 0, 0);
 }
 
 #endif //NATURE_RUNTIME_NUTILS_TLS_H_
@@ -179,15 +179,16 @@ void rt_uv_udp_close(n_udp_socket_t *s) {
         return;
     }
 
-    global_waiting_send(uv_async_udp_close, s, 0, 0);
+    // handle 只能在 bind 时所在 processor 的 loop 上关闭
+    loop_waiting_send(s->handle->loop, uv_async_udp_close, s, 0, 0);
 
     s->closed = true;
-    DEBUGF("[rt_uv_udp_close] close success, handle_count=%ld", global.async_handle_count)
+    DEBUGF("[rt_uv_udp_close] close success")
 }
 
 static void uv_async_udp_bind(n_udp_socket_t *s) {
     DEBUGF("[uv_async_udp_bind] start, co %p", s->co)
-    uv_udp_init_ex(&global_loop, s->handle, AF_UNSPEC | UV_UDP_RECVMMSG);
+    uv_udp_init_ex(processor_loop(), s->handle, AF_UNSPEC | UV_UDP_RECVMMSG);
     s->handle->data = s;
 
     struct sockaddr_in addr = {0};
@@ -230,7 +231,7 @@ void rt_uv_udp_bind(n_udp_socket_t *s) {
     s->co = co;
     s->handle = mallocz(sizeof(uv_udp_t));
 
-    global_waiting_send(uv_async_udp_bind, s, 0, 0);
+    loop_waiting_send(processor_loop(), uv_async_udp_bind, s, 0, 0);
 
     DEBUGF("[rt_uv_udp_bind] bind success, will return")
 }
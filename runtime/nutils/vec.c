@@ -210,7 +210,12 @@ void rti_vec_assign(n_vec_t *l, uint64_t index, void *ref, rtype_t *element_rtyp
 
     memmove(p, ref, l->element_size);
 
-    if (!gc_barrier_get() || element_rtype->last_ptr == 0) {
+    if (element_rtype->last_ptr == 0) {
+        return;
+    }
+
+    card_mark_range((addr_t) p, l->element_size);
+    if (!gc_barrier_get()) {
         return;
     }
 
@@ -341,7 +346,11 @@ void rt_vec_append(n_vec_t *dst, n_vec_t *src, int64_t element_hash) {
         rti_vec_grow(dst, element_rtype, dst->length + src->length + 1);
     }
 
-    memmove(dst->data + dst->length * dst->element_size, src->data, src->length * src->element_size);
+    void *dst_ref = dst->data + dst->length * dst->element_size;
+    memmove(dst_ref, src->data, src->length * src->element_size);
+    if (element_rtype->last_ptr > 0) {
+        rti_write_barrier_range(dst_ref, src->length * src->element_size);
+    }
     dst->length += src->length;
 }
 
@@ -447,6 +456,7 @@ uint64_t rt_vec_copy(n_vec_t *dst, n_vec_t src) {
 
     if (copy_len > 0) {
         memmove(dst->data, src.data, copy_len * src.element_size);
+        rti_write_barrier_range(dst->data, copy_len * src.element_size);
     }
 
     DEBUGF("[rt_vec_copy] copied %lu elements from %p to %p", copy_len, src, dst);
@@ -4,29 +4,25 @@
 #ifndef __WINDOWS
 #include <ucontext.h>
 #endif
+#ifdef __LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "nutils/errort.h"
 #include "nutils/rt_signal.h"
 #include "runtime.h"
 #include "runtime/nutils/http.h"
 
-#if defined(__DARWIN) || defined(__WINDOWS)
-#define PROCESSOR_IDLE_SLEEP_US 1000
-#else
-#define PROCESSOR_IDLE_SLEEP_US 1
-#endif
-
 int cpu_count;
 
+io_backend_t io_backend = IO_BACKEND_LIBUV;
+
 n_processor_t *processor_index[1024] = {0};
 n_processor_t *processor_list; // 共享协程列表的数量一般就等于线程数量
 
 _Atomic uint64_t race_detector_counter = 0;
 
-uv_loop_t global_loop; // uv loop 事件循环
-
-global_handle_t global = {0};
-
 int64_t coroutine_count; // coroutine 累计数量
 bool main_coroutine_exited = false;
 
@@ -42,8 +38,16 @@ _Thread_local int64_t tls_yield_safepoint = false;
 _Thread_local __attribute__((tls_model("local-exec"))) int64_t tls_yield_safepoint = false;
 #endif
 
+_Thread_local n_processor_t *tls_run_processor = NULL;
+
 __attribute__((aligned(128))) aligned_page_t global_safepoint = {0};
 
+// stw 屏障: processor 在安全点中 park, global_safepoint 与 in_stw 的更新都需要持有 stw_locker
+static uv_mutex_t stw_locker;
+static uv_cond_t stw_safe_cond; // processor 进入安全点或者退出时通知 gc 线程
+static uv_cond_t stw_resume_cond; // start the world 时唤醒所有 park 的 processor
+static uint64_t stw_resume_at; // 最近一次 start the world 的时间
+
 uint64_t assist_preempt_yield_ret_addr = 0;
 
 
@@ -85,7 +89,7 @@ NO_OPTIMIZE void co_preempt_yield() {
 
     // 不需要等待，直接设置为 runnable 状态
     co->status = CO_STATUS_RUNNABLE;
-    rt_linked_fixalloc_push(&p->runnable_list, co);
+    rt_mpsc_push_local(&p->runnable_list, co);
 
     *p->tls_yield_safepoint_ptr = false; // 清空状态
     DEBUGF("[runtime.co_preempt_yield] co=%p push and update status success", co);
@@ -271,16 +275,21 @@ NO_OPTIMIZE static void coroutine_wrapper() {
 
     // coroutine 即将退出，避免被 gc 清理，所以将 error保存在 co->future 中?
     if (co->has_error && co->future) {
-        union_casting(&co->future->error, throwable_rtype.hash, &co->error); // 将 co error 赋值给 co->future 避免被 gc
+        union_casting((n_union_t *) &co->future->error, throwable_rtype.hash, &co->error); // 将 co error 赋值给 co->future 避免被 gc
+        rti_write_barrier_range(&co->future->error, sizeof(co->future->error));
+    }
+
+    // 与 rt_coroutine_await 竞争 future->co, exchange 之后 await 方不会再注册等待
+    void *await_state = NULL;
+    if (co->future) {
+        await_state = atomic_exchange(&co->future->co, NULL);
     }
 
-    // co->await_co 可能是随时写入的，所以需要 dead_locker 保证同步
-    mutex_lock(&co->dead_locker);
-    if (co->await_co) {
-        coroutine_t *await_co = co->await_co;
+    if ((addr_t) await_state & FUTURE_AWAIT_TAG) {
+        coroutine_t *await_co = (coroutine_t *) ((addr_t) await_state & ~(addr_t) FUTURE_AWAIT_TAG);
 
         co_set_status(p, await_co, CO_STATUS_RUNNABLE);
-        rt_linked_fixalloc_push(&await_co->p->runnable_list, await_co);
+        processor_runnable_push(await_co->p, await_co);
     } else {
         if (co->has_error) {
             coroutine_dump_error(co);
@@ -294,8 +303,6 @@ NO_OPTIMIZE static void coroutine_wrapper() {
         DEBUGF("[runtime.coroutine_wrapper] co=%p main exited", co);
     }
 
-    mutex_unlock(&co->dead_locker);
-
     DEBUGF("[runtime.coroutine_wrapper] co=%p will dead", co);
     aco_exit1(&co->aco);
 }
@@ -323,11 +330,17 @@ void processor_all_need_stop() {
     //    PROCESSOR_FOR(processor_list) {
     //        p->need_stw = stw_time;
     //    }
-    global_safepoint.value = uv_hrtime();
+    uv_mutex_lock(&stw_locker);
+    global_safepoint.value = uv_hrtime(); // 同时作为 stw 的请求时间
+    uv_mutex_unlock(&stw_locker);
 }
 
 void processor_all_start() {
+    uv_mutex_lock(&stw_locker);
+    stw_resume_at = uv_hrtime();
     global_safepoint.value = 0;
+    uv_cond_broadcast(&stw_resume_cond);
+    uv_mutex_unlock(&stw_locker);
 
     //    PROCESSOR_FOR(processor_list) {
     //        p->need_stw = 0;
@@ -398,7 +411,132 @@ void coroutine_resume(n_processor_t *p, coroutine_t *co) {
             co->flag & FLAG(CO_FLAG_RTFN));
 }
 
+/**
+ * 优先处理 runnable_list 中已经运行过的 coroutine, 但每 61 次调度会优先检查一次 runq,
+ * 避免 runnable_list 持续不为空时新的 coroutine 一直得不到运行
+ */
+static coroutine_t *processor_next(n_processor_t *p) {
+    // 其他线程 handoff 的 coroutine 优先运行
+    coroutine_t *co = p->runnext;
+    if (co && atomic_compare_exchange_strong(&p->runnext, &co, NULL)) {
+        return co;
+    }
+
+    co = NULL;
+    p->sched_tick += 1;
+    if (p->sched_tick % 61 == 0) {
+        co = rt_runq_pop(&p->runq);
+        if (co) {
+            return co;
+        }
+    }
+
+    co = rt_mpsc_pop(&p->runnable_list);
+    if (co) {
+        return co;
+    }
+
+    return rt_runq_pop(&p->runq);
+}
+
+static inline uint64_t processor_rand(n_processor_t *p) {
+    // xorshift64
+    uint64_t x = p->steal_rand;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    p->steal_rand = x;
+    return x;
+}
+
+/**
+ * 从随机选择的其他 processor 的 runq 中 steal 一半尚未运行的 coroutine 到当前 processor
+ *
+ * 只有尚未 resume 过的 coroutine 会进入 runq, 其还没有绑定 share_stack, 所以可以安全的在 processor 之间迁移。
+ * 已经运行过的 coroutine 不能通过 co_migrate 迁移: co_migrate 只修正了栈上的 bp 链, 而栈上以及 save_stack 中
+ * 还存在大量指向栈内部的地址(取地址的局部变量、按引用传递的 struct、寄存器溢出到栈上的栈地址等),
+ * 编译器没有提供这些位置的信息, 迁移到新的 share_stack 后这些地址全部失效。
+ * gc_work 会无锁遍历 co_list, 所以 steal 只在 GC_STAGE_OFF/GC_STAGE_SWEEP(mark 已经完成) 阶段进行，steal 过程中当前 processor 不会进入安全点,
+ * 因此 gc 开始 stw 之前 co_list 的迁移一定已经完成。
+ * @return 是否 steal 到了 coroutine
+ */
+static bool processor_steal(n_processor_t *p) {
+    if (cpu_count <= 1 || (gc_stage != GC_STAGE_OFF && gc_stage != GC_STAGE_SWEEP)) {
+        return false;
+    }
+
+    int start = (int) (processor_rand(p) % cpu_count);
+    for (int i = 0; i < cpu_count; ++i) {
+        n_processor_t *victim = processor_index[(start + i) % cpu_count];
+        if (!victim || victim == p || !victim->thread_waked) {
+            continue;
+        }
+
+        uint64_t steal_count = (rt_runq_size(&victim->runq) + 1) / 2;
+        uint64_t stolen = 0;
+        for (; stolen < steal_count; stolen++) {
+            coroutine_t *co = rt_runq_pop(&victim->runq);
+            if (!co) {
+                break;
+            }
+
+            // co_list 迁移
+            rt_linked_fixalloc_remove(&victim->co_list, co->co_node);
+            co->co_node = rt_linked_fixalloc_push(&p->co_list, co);
+
+            if (!rt_runq_push(&p->runq, co)) {
+                rt_mpsc_push_local(&p->runnable_list, co);
+            }
+        }
+
+        if (stolen > 0) {
+            DEBUGF("[runtime.processor_steal] p_index=%d steal %lu co from p_index=%d", p->index, stolen,
+                   victim->index);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 // handle by thread
+/**
+ * 在安全点中等待 start the world, 进入安全点时通知 gc 线程
+ */
+static void processor_stw_park(n_processor_t *p) {
+    uv_mutex_lock(&stw_locker);
+    uint64_t safepoint = global_safepoint.value;
+    if (safepoint == 0) {
+        // gc 已经 start the world
+        uv_mutex_unlock(&stw_locker);
+        return;
+    }
+
+    uint64_t safe_ns = uv_hrtime() - safepoint;
+    p->in_stw = safepoint; // 进入 stw 状态
+    uv_cond_signal(&stw_safe_cond);
+
+    // runtime_gc 线程会解除 safe 状态，所以这里一直等待直到 global_safepoint 被更新即可
+    while (p->in_stw == global_safepoint.value) {
+        uv_cond_wait(&stw_resume_cond, &stw_locker);
+    }
+    uint64_t resume_at = stw_resume_at;
+    uv_mutex_unlock(&stw_locker);
+
+    // 只有当前线程会写入 stw_stats
+    uint64_t resume_ns = uv_hrtime() - resume_at;
+    stw_stats_t *stats = &p->stw_stats;
+    stats->stw_count += 1;
+    stats->safepoint_total_ns += safe_ns;
+    stats->resume_total_ns += resume_ns;
+    if ((int64_t) safe_ns > stats->safepoint_max_ns) {
+        stats->safepoint_max_ns = safe_ns;
+    }
+    if ((int64_t) resume_ns > stats->resume_max_ns) {
+        stats->resume_max_ns = resume_ns;
+    }
+}
+
 static void processor_run(void *raw) {
     n_processor_t *p = raw;
     DEBUGF("[runtime.processor_run] start, p_index=%d, addr=%p, yield_safepoint_ptr=%p(%ld)", p->index, p, &tls_yield_safepoint, tls_yield_safepoint);
@@ -413,33 +551,23 @@ static void processor_run(void *raw) {
 
     aco_share_stack_init(&p->share_stack, 0);
 
-    // - 初始化 libuv
-    //    uv_loop_init(&p->uv_loop);
-    //    uv_timer_init(&p->uv_loop, &p->timer);
-
     p->tls_yield_safepoint_ptr = &tls_yield_safepoint;
 
     // 注册线程信号监听, 用于抢占式调度
     // 将 p 存储在线程维度全局遍历中，方便直接在 coroutine 运行中读取相关的 processor
     uv_key_set(&tls_processor_key, p);
+    tls_run_processor = p;
 
     // 对 p 进行调度处理(p 上面可能还没有 coroutine)
     while (true) {
-        TRACEF("[runtime.processor_run] handle, p_index=%d, main_exited=%d, running_count=%ld", p->index, main_coroutine_exited,
-               p->runnable_list.count);
+        TRACEF("[runtime.processor_run] handle, p_index=%d, main_exited=%d, runq_size=%lu", p->index, main_coroutine_exited,
+               rt_runq_size(&p->runq));
 
         // - stw
         if (global_safepoint.value > 0) {
         STW_WAIT:
             DEBUGF("[runtime.processor_run] need stw, global_safepoint=%ld, p_index=%d, main_exited=%d", global_safepoint.value, p->index, main_coroutine_exited);
-            p->in_stw = global_safepoint.value; // 进入 stw 状态
-
-            // runtime_gc 线程会解除 safe 状态，所以这里一直等待直到 global_safepoint 清零即可
-            while (p->in_stw == global_safepoint.value) {
-                TRACEF("[runtime.processor_run] p_index=%d, need_stw=%lu, safe_point=%lu stw loop....", p->index,
-                       p->need_stw, p->in_stw);
-                usleep(WAIT_BRIEF_TIME * 1000); // 1ms
-            }
+            processor_stw_park(p);
 
             DEBUGF("[runtime.processor_run] p_index=%d, stw completed, safe_point=%lu, main_exited=%d, global_safepoint=%ld",
                    p->index,
@@ -454,7 +582,7 @@ static void processor_run(void *raw) {
 
         int64_t handle_limit = 61;
         while (handle_limit > 0) {
-            coroutine_t *co = rt_linked_fixalloc_pop(&p->runnable_list);
+            coroutine_t *co = processor_next(p);
             if (co == NULL) {
                 break;
             }
@@ -473,25 +601,37 @@ static void processor_run(void *raw) {
             }
         }
 
-        if (rt_linked_fixalloc_empty(&p->runnable_list)) {
+        if (processor_runnable_empty(p) && rt_runq_size(&p->runq) == 0) {
+            // 本地没有可以运行的 coroutine, 先尝试从其他 processor 中 steal
+            if (processor_steal(p)) {
+                processor_loop_run(p, 0);
+                continue;
+            }
+
             // 阻塞运行
-            global_loop_run(1);
+            processor_loop_run(p, 1);
         } else {
-            global_loop_run(0);
+            processor_loop_run(p, 0);
         }
     }
 
 EXIT:
+    tls_run_processor = NULL;
     p->thread_id = 0;
     processor_set_status(p, P_STATUS_EXIT);
 
+    // 退出的 processor 被视为已经到达安全点
+    uv_mutex_lock(&stw_locker);
+    uv_cond_signal(&stw_safe_cond);
+    uv_mutex_unlock(&stw_locker);
+
     DEBUGF("[runtime.processor_run] exited, p_index=%d", p->index);
 }
 
 /**
  * 如果 P 的线程未启动，则启动它
  */
-static void processor_wake(n_processor_t *p) {
+void processor_wake(n_processor_t *p) {
     // 原子 CAS：如果已创建过则直接返回
     bool expected = false;
     if (!atomic_compare_exchange_strong(&p->thread_waked, &expected, true)) {
@@ -547,12 +687,62 @@ void rt_coroutine_dispatch(coroutine_t *co) {
     // 按需启动 P 的线程
     processor_wake(select_p);
 
-    rt_linked_fixalloc_push(&select_p->co_list, co);
-    rt_linked_fixalloc_push(&select_p->runnable_list, co);
+    co->co_node = rt_linked_fixalloc_push(&select_p->co_list, co);
+
+    // 新的 coroutine 进入 runq 可以被其他空闲的 processor steal, main 与 SAME 必须在指定的 processor 上运行
+    if (co->main || co->flag & FLAG(CO_FLAG_SAME) || !rt_runq_push(&select_p->runq, co)) {
+        processor_runnable_push(select_p, co);
+    }
 
     DEBUGF("[runtime.rt_coroutine_dispatch] co=%p to p_index=%d, end", co, select_p->index);
 }
 
+/**
+ * 探测内核是否允许创建 io_uring(内核版本过低或者被 seccomp 禁用时失败)
+ */
+static bool io_uring_probe() {
+#if defined(__LINUX) && defined(__NR_io_uring_setup)
+    // struct io_uring_params 共 120 字节, 全部置零即可创建最小的 ring
+    uint64_t params[15] = {0};
+    long fd = syscall(__NR_io_uring_setup, 1, params);
+    if (fd < 0) {
+        return false;
+    }
+    close((int) fd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * libuv 是否通过 io_uring 提交文件 io 由 UV_USE_IO_URING 控制(1.49 之后还需要 loop 配置 UV_LOOP_USE_IO_URING_SQPOLL),
+ * 否则文件 io 在线程池中同步执行。环境变量需要在第一个 loop 初始化之前设置, libuv 会缓存读取结果
+ *
+ * 默认的 libuv 后端显式关闭 io_uring(用户自行设置了 UV_USE_IO_URING 时不覆盖), 避免不同 libuv 版本的默认行为不一致
+ */
+static void io_backend_init(char *backend) {
+#ifdef __LINUX
+    if (!backend || !str_equal(backend, "uring")) {
+        setenv("UV_USE_IO_URING", "0", 0);
+        return;
+    }
+
+    if (!io_uring_probe()) {
+        DEBUGF("[runtime.io_backend_init] io_uring not supported, fallback to libuv");
+        setenv("UV_USE_IO_URING", "0", 0);
+        return;
+    }
+
+    setenv("UV_USE_IO_URING", "1", 1);
+    io_backend = IO_BACKEND_URING;
+#endif
+}
+
+char *runtime_io_backend() {
+    return io_backend == IO_BACKEND_URING ? "uring" : "libuv";
+}
+
 /**
  * 各种全局变量初始化都通过该方法
  */
@@ -569,15 +759,27 @@ void sched_init(bool use_t0) {
     uv_cpu_info(&info, &cpu_count);
     uv_free_cpu_info(info, cpu_count);
 
+    // 通过 NATURE_MAXPROCS 限制 processor 的数量
+    char *max_procs = getenv("NATURE_MAXPROCS");
+    if (max_procs) {
+        int n = atoi(max_procs);
+        if (n > 0 && n <= 1024) {
+            cpu_count = n;
+        }
+    }
+
+    // 通过 NATURE_IO_BACKEND=uring 选择 io_uring 后端, 默认以及内核不支持时使用 libuv 线程池 + epoll
+    io_backend_init(getenv("NATURE_IO_BACKEND"));
+
     // - 初始化全局标识
     gc_barrier = false;
+    uv_mutex_init(&stw_locker);
+    uv_cond_init(&stw_safe_cond);
+    uv_cond_init(&stw_resume_cond);
     mutex_init(&gc_stage_locker, false);
     gc_stage = GC_STAGE_OFF;
     coroutine_count = 0;
 
-    // - 初始化 global libuv
-    global_loop_init();
-
     // - 初始化 global linkco
     mutex_init(&global_linkco_locker, false);
     global_linkco_cache = NULL;
@@ -600,7 +802,7 @@ void sched_init(bool use_t0) {
 
     for (int i = 0; i < cpu_count; ++i) {
         n_processor_t *p = processor_new(i);
-        rt_linked_fixalloc_init(&p->gc_worklist);
+        rt_worklist_init(&p->gc_worklist);
         p->gc_work_finished = memory->gc_count;
         processor_index[p->index] = p;
 
@@ -732,6 +934,11 @@ coroutine_t *rt_coroutine_new(void *fn, int64_t flag, n_future_t *fu, void *arg)
     // 通过 shade 避免 fu 在本轮中被 gc
     rt_shade_obj_with_barrier(fu);
 
+    // 必须在 dispatch 之前写入, dispatch 之后 co 可能在其他 processor 上立即运行并退出
+    if (fu) {
+        fu->co = co;
+    }
+
     co->future = fu;
     co->fn = fn;
     co->main = FLAG(CO_FLAG_MAIN) & flag;
@@ -748,7 +955,7 @@ coroutine_t *rt_coroutine_new(void *fn, int64_t flag, n_future_t *fu, void *arg)
     co->has_error = false;
     co->error = (n_interface_t){0};
     co->traces = (n_vec_t){0};
-    co->await_co = NULL;
+    co->co_node = NULL;
     co->aco.inited = 0; // 标记为为初始化
 
     return co;
@@ -761,9 +968,10 @@ n_processor_t *processor_new(int index) {
     n_processor_t *p = fixalloc_alloc(&processor_alloc);
     mutex_unlock(&cp_alloc_locker);
 
-    // uv_loop_init(&p->uv_loop);
-    //    mutex_init(&p->gc_solo_stw_locker, false);
+    // - 初始化 processor 独立的 libuv loop
+    processor_loop_init(p);
     p->in_stw = 0;
+    p->stw_stats = (stw_stats_t){0};
 
     sc_map_init_64v(&p->caller_cache, 100, 0);
     mutex_init(&p->thread_locker, false);
@@ -777,7 +985,11 @@ n_processor_t *processor_new(int index) {
     p->co_started_at = 0;
     p->mcache.flush_gen = 0; // 线程维度缓存，避免内存分配锁
     rt_linked_fixalloc_init(&p->co_list);
-    rt_linked_fixalloc_init(&p->runnable_list);
+    rt_mpsc_init(&p->runnable_list, offsetof(coroutine_t, next));
+    rt_runq_init(&p->runq);
+    p->runnext = NULL;
+    p->sched_tick = 0;
+    p->steal_rand = (uint64_t) (index + 1) * 0x9e3779b97f4a7c15ULL;
     p->index = index;
     p->next = NULL;
 
@@ -811,7 +1023,7 @@ void processor_free(n_processor_t *p) {
 
     aco_share_stack_destroy(&p->share_stack);
     rt_linked_fixalloc_free(&p->co_list);
-    rt_linked_fixalloc_free(&p->runnable_list);
+    rt_worklist_free(&p->gc_worklist);
     aco_destroy(&p->main_aco);
 
     // 归还 mcache span
@@ -867,22 +1079,43 @@ bool processor_all_safe() {
     return true;
 }
 
+/**
+ * 最多等待 max_count 个 WAIT_BRIEF_TIME, processor 进入安全点时会通过 stw_safe_cond 立即唤醒 gc 线程
+ */
 bool processor_all_wait_safe(int max_count) {
-    int count = 0;
     RDEBUGF("[processor_all_wait_safe] start");
+    uint64_t deadline = uv_hrtime() + (uint64_t) max_count * WAIT_BRIEF_TIME * 1000 * 1000;
+
+    uv_mutex_lock(&stw_locker);
     while (!processor_all_safe()) {
-        if (count >= max_count) {
-            return false; // T
+        uint64_t now = uv_hrtime();
+        if (now >= deadline) {
+            uv_mutex_unlock(&stw_locker);
+            return false;
         }
 
-        count += 1;
-        usleep(WAIT_BRIEF_TIME * 1000); // 每 1ms 检测一次
+        uv_cond_timedwait(&stw_safe_cond, &stw_locker, deadline - now);
     }
+    uv_mutex_unlock(&stw_locker);
 
     RDEBUGF("[processor_all_wait_safe] end");
     return true;
 }
 
+bool runtime_processor_stw_stats(int64_t index, stw_stats_t *out) {
+    assert(out);
+    if (index < 0 || index >= cpu_count) {
+        return false;
+    }
+
+    *out = processor_index[index]->stw_stats;
+    return true;
+}
+
+int64_t runtime_processor_count() {
+    return cpu_count;
+}
+
 /**
  * 遍历所有的 share processor 和 solo processor 判断 gc 是否全部完成
  * @return
@@ -1035,203 +1268,198 @@ void rt_coroutine_return(void *result_ptr) {
     assert(co->future->size > 0);
 
     memmove(co->future->result, result_ptr, co->future->size);
+    rti_write_barrier_range(co->future->result, co->future->size);
     DEBUGF("[runtime.rt_coroutine_return] co=%p, result=%p, int_result=%ld, result_size=%ld", co, co->future->result,
            *(int64_t *) co->future->result, co->future->size);
 }
 
-void rt_coroutine_await(coroutine_t *target_co) {
-    mutex_lock(&target_co->dead_locker);
+void rt_coroutine_await(n_future_t *fu) {
     coroutine_t *src_co = coroutine_get();
-    if (target_co->status == CO_STATUS_DEAD) {
-        mutex_unlock(&target_co->dead_locker);
+    void *target_co = atomic_load(&fu->co);
+    if (!target_co) {
         return;
     }
-    target_co->await_co = src_co;
+    assertf(!((addr_t) target_co & FUTURE_AWAIT_TAG), "future=%p already awaited by another coroutine", fu);
+
+    // 先设置 waiting 再发布等待方, 发布之后 coroutine_wrapper 随时可能将 src_co 设置为 runnable
+    co_status_t status = src_co->status;
     co_set_status(src_co->p, src_co, CO_STATUS_WAITING);
-    mutex_unlock(&target_co->dead_locker);
+    void *await_state = (void *) ((addr_t) src_co | FUTURE_AWAIT_TAG);
+    if (!atomic_compare_exchange_strong(&fu->co, &target_co, await_state)) {
+        // target co 已经退出
+        assert(target_co == NULL);
+        co_set_status(src_co->p, src_co, status);
+        return;
+    }
 
-    // 一旦 unlock 就可能会发生 runnable push 以及 status set, 但是不影响当前 yield
+    // 唤醒时 src_co 会被 push 到 src_co->p 的 runnable_list, 只有当前线程会消费, 所以不影响当前 yield
     _co_yield(src_co->p, src_co);
 
     // waiting -> syscall
     co_set_status(src_co->p, src_co, CO_STATUS_TPLCALL);
 }
 
-// global_loop_run 的超时回调函数
-static void global_loop_timeout_cb(uv_timer_t *timer) {
-    // uv_timer_stop(timer);
+// processor_loop_run 的超时回调函数
+static void processor_loop_timeout_cb(uv_timer_t *timer) {
     uv_stop(timer->loop);
-    TRACEF("[runtime.global_loop_timeout_cb] timeout triggered, stopping loop");
+    TRACEF("[runtime.processor_loop_timeout_cb] timeout triggered, stopping loop");
 }
 
 /**
+ * 只能由 p 的线程调用, 每个 processor 只运行自己的 loop, 不再竞争全局 loop 的所有权
  * loop_timeout_ms = 0 表示不阻塞，直接调用 no wait, 1 表示阻塞 1ms, 2ms
  */
-
-void global_loop_run(int loop_timeout_ms) {
-    int32_t expected = 0;
-
-    if (!atomic_compare_exchange_weak_explicit(&global.loop_owner, &expected, 1, memory_order_acquire, memory_order_relaxed)) {
-        if (loop_timeout_ms > 0) {
-            usleep(PROCESSOR_IDLE_SLEEP_US);
-        }
-        return; // 继续处理
-    }
+void processor_loop_run(n_processor_t *p, int loop_timeout_ms) {
     if (loop_timeout_ms == 0) {
-        uv_run(&global_loop, UV_RUN_NOWAIT);
-    } else {
-        uv_timer_start(&global.timer, global_loop_timeout_cb, loop_timeout_ms, 0);
-        uv_run(&global_loop, UV_RUN_ONCE);
+        uv_run(p->uv_loop, UV_RUN_NOWAIT);
+        return;
     }
 
-    atomic_store_explicit(&global.loop_owner, 0, memory_order_release);
-    TRACEF("[runtime.global_loop_run] released global_loop ownership");
+    uv_timer_start(&p->timer, processor_loop_timeout_cb, loop_timeout_ms, 0);
+    uv_run(p->uv_loop, UV_RUN_ONCE);
 }
 
-
+/**
+ * handle 总是由当前线程的 processor 分配, 由 loop 所属 processor 的线程释放, 所以 freelist 不需要加锁
+ * 跨 processor 投递时 handle 会流向目标 processor 的 freelist, 超过上限之后直接 free
+ */
 static async_handle_t *acquire_async_handle() {
-    pthread_mutex_lock(&global.freelist_lock);
-    if (global.freelist_count > 0) {
-        async_handle_t *node = global.freelist;
-        global.freelist = node->next;
+    n_processor_t *p = tls_run_processor;
+    if (p && p->async_freelist_count > 0) {
+        async_handle_t *node = p->async_freelist;
+        p->async_freelist = node->next;
         node->next = NULL;
-        global.freelist_count--;
-        pthread_mutex_unlock(&global.freelist_lock);
+        p->async_freelist_count--;
         return node;
     }
 
-    pthread_mutex_unlock(&global.freelist_lock);
     return malloc(sizeof(async_handle_t));
 }
 
 static void release_async_handle(async_handle_t *node) {
-    pthread_mutex_lock(&global.freelist_lock);
-    if (global.freelist_count > ASYNC_HANDLE_FREELIST_MAX) {
+    n_processor_t *p = tls_run_processor;
+    if (!p || p->async_freelist_count > ASYNC_HANDLE_FREELIST_MAX) {
         free(node);
-        pthread_mutex_unlock(&global.freelist_lock);
         return;
     }
 
-    node->next = global.freelist;
-    global.freelist = node;
-    global.freelist_count++;
-    pthread_mutex_unlock(&global.freelist_lock);
-}
-
-static void init_async_handle_freelist() {
-    for (int i = 0; i < ASYNC_HANDLE_FREELIST_MIN; ++i) {
-        async_handle_t *node = malloc(sizeof(async_handle_t));
-
-        node->next = global.freelist;
-        global.freelist = node;
-        global.freelist_count += 1;
-    }
-}
-
-// global async queue
-void global_loop_init() {
-    uv_loop_init(&global_loop);
-
-    global.async_queue = NULL;
-    pthread_mutex_init(&global.async_lock, NULL);
-    pthread_mutex_init(&global.freelist_lock, NULL);
-
-    // 初始化全局 async handle
-    uv_async_init(&global_loop, &global.async_handle, global_async_queue_process_cb);
-    init_async_handle_freelist();
-
-    uv_async_init(&global_loop, &global.async_weak, global_async_weak_cb);
-    uv_timer_init(&global_loop, &global.timer);
-
-
-    DEBUGF("[runtime.global_loop_init] global async queue initialized");
+    node->next = p->async_freelist;
+    p->async_freelist = node;
+    p->async_freelist_count++;
 }
 
-
-static inline bool global_async_handle_register(coroutine_t *co, void *data) {
-    async_handle_t *handle = data;
-    // 在 waiting 中进行注册以及触发
-    pthread_mutex_lock(&global.async_lock);
-    handle->next = global.async_queue;
-    global.async_queue = handle;
-    pthread_mutex_unlock(&global.async_lock);
-
-    // 触发 libuv async handle
-    uv_async_send(&global.async_handle);
-
-    return true;
-}
-
-void global_waiting_send(void *fn, void *arg1, void *arg2, void *arg3) {
+static async_handle_t *new_async_handle(uv_loop_t *loop, void *fn, void *arg1, void *arg2, void *arg3) {
     assert(fn);
+    assert(loop && loop->data);
 
     async_handle_t *handle = acquire_async_handle();
-
+    handle->loop = loop;
     handle->fn = (async_fn) fn;
     handle->arg1 = arg1;
     handle->arg2 = arg2;
     handle->arg3 = arg3;
     handle->next = NULL;
-
-    co_yield_waiting(coroutine_get(), global_async_handle_register, handle);
+    return handle;
 }
 
+/**
+ * 在 processor_new 中调用, 此时 p 的线程还没有启动, loop 之后只会在 p 的线程中运行
+ */
+void processor_loop_init(n_processor_t *p) {
+    p->uv_loop = malloc(sizeof(uv_loop_t));
+    uv_loop_init(p->uv_loop);
+    p->uv_loop->data = p;
+    if (io_backend == IO_BACKEND_URING) {
+        // 每个 loop 独立持有 sqpoll ring, 同一轮 uv_run 中产生的提交由内核线程批量消费
+        uv_loop_configure(p->uv_loop, UV_LOOP_USE_IO_URING_SQPOLL);
+    }
 
-void global_async_send(void *fn, void *arg1, void *arg2, void *arg3) {
-    assert(fn);
+    p->async_queue = NULL;
+    pthread_mutex_init(&p->async_lock, NULL);
+    uv_async_init(p->uv_loop, &p->async_handle, processor_async_queue_process_cb);
+    uv_timer_init(p->uv_loop, &p->timer);
 
-    // 线程安全地添加到队列
+    p->async_freelist = NULL;
+    p->async_freelist_count = 0;
+    for (int i = 0; i < ASYNC_HANDLE_FREELIST_MIN; ++i) {
+        async_handle_t *node = malloc(sizeof(async_handle_t));
+        node->next = p->async_freelist;
+        p->async_freelist = node;
+        p->async_freelist_count += 1;
+    }
+}
 
-    // 分配 async_handle_t
-    async_handle_t *handle = acquire_async_handle();
-    handle->fn = (async_fn) fn;
-    handle->arg1 = arg1;
-    handle->arg2 = arg2;
-    handle->arg3 = arg3;
-    handle->next = NULL;
+static void loop_async_handle_push(async_handle_t *handle) {
+    n_processor_t *p = handle->loop->data;
 
+    pthread_mutex_lock(&p->async_lock);
+    handle->next = p->async_queue;
+    p->async_queue = handle;
+    pthread_mutex_unlock(&p->async_lock);
 
-    pthread_mutex_lock(&global.async_lock);
-    handle->next = global.async_queue;
-    global.async_queue = handle;
-    pthread_mutex_unlock(&global.async_lock);
+    // 触发目标 loop 的 async handle
+    uv_async_send(&p->async_handle);
+}
 
-    // 触发 libuv async handle
-    uv_async_send(&global.async_handle);
+static inline void loop_async_handle_call(async_handle_t *handle) {
+    handle->fn(handle->arg1, handle->arg2, handle->arg3);
+    release_async_handle(handle);
+}
 
-    DEBUGF("[runtime.global_async_send] async task pushed, fn=%p, arg=%p", fn, arg);
+// 在 coroutine yield 之后由 coroutine_resume 调用, 此时已经回到 p 的线程栈上
+static inline bool loop_waiting_handle_call(coroutine_t *co, void *data) {
+    loop_async_handle_call(data);
+    return true;
 }
 
-void global_async_weak_cb(uv_async_t *handle) {
-    // not anything
+static inline bool loop_waiting_handle_register(coroutine_t *co, void *data) {
+    loop_async_handle_push(data);
+    return true;
 }
 
-void global_async_queue_process_cb(uv_async_t *handle) {
-    DEBUGF("[runtime.global_async_queue_process_cb] processing async queue");
-    if (global.async_queue == NULL) {
+void loop_waiting_send(uv_loop_t *loop, void *fn, void *arg1, void *arg2, void *arg3) {
+    async_handle_t *handle = new_async_handle(loop, fn, arg1, arg2, arg3);
+    coroutine_t *co = coroutine_get();
+
+    // loop 属于当前 processor 时不需要经过 async 队列, yield 之后在当前线程直接执行
+    if (loop->data == tls_run_processor) {
+        co_yield_waiting(co, loop_waiting_handle_call, handle);
+    } else {
+        co_yield_waiting(co, loop_waiting_handle_register, handle);
+    }
+}
+
+void loop_async_send(uv_loop_t *loop, void *fn, void *arg1, void *arg2, void *arg3) {
+    async_handle_t *handle = new_async_handle(loop, fn, arg1, arg2, arg3);
+
+    // 当前线程就是 loop 的 owner, 并且 uv_run 不会与 coroutine 同时运行, 可以直接执行
+    if (loop->data == tls_run_processor) {
+        loop_async_handle_call(handle);
         return;
     }
 
-    async_handle_t *tasks = NULL;
+    loop_async_handle_push(handle);
+    DEBUGF("[runtime.loop_async_send] async task pushed, fn=%p, p_index=%d", fn, ((n_processor_t *) loop->data)->index);
+}
+
+void processor_async_queue_process_cb(uv_async_t *handle) {
+    n_processor_t *p = handle->loop->data;
+    if (p->async_queue == NULL) {
+        return;
+    }
 
     // 获取所有待处理任务
-    pthread_mutex_lock(&global.async_lock);
-    tasks = global.async_queue;
-    global.async_queue = NULL;
-    pthread_mutex_unlock(&global.async_lock);
+    pthread_mutex_lock(&p->async_lock);
+    async_handle_t *tasks = p->async_queue;
+    p->async_queue = NULL;
+    pthread_mutex_unlock(&p->async_lock);
 
     // 处理所有任务
     while (tasks != NULL) {
         async_handle_t *current = tasks;
         tasks = tasks->next;
-
-        current->fn(current->arg1, current->arg2, current->arg3);
-
-        atomic_fetch_add(&global.async_handle_count, 1);
-
-        // 释放 handle
-        release_async_handle(current);
+        loop_async_handle_call(current);
     }
 
-    DEBUGF("[runtime.global_async_queue_process_cb] async queue processing completed");
+    DEBUGF("[runtime.processor_async_queue_process_cb] p_index=%d async queue processing completed", p->index);
 }
@@ -19,43 +19,27 @@ typedef void (*async_fn)(void *, void *, void *);
 
 typedef struct async_handle_t {
     struct async_handle_t *next;
+    uv_loop_t *loop; // 目标 loop, 只能由 loop->data 对应的 processor 线程执行
     void *arg1;
     void *arg2;
     void *arg3;
     async_fn fn;
 } async_handle_t;
 
-typedef struct {
-    async_handle_t *async_queue; // 单向链表
-    pthread_mutex_t async_lock; // 链表 lock
-    _Atomic int32_t loop_owner;
-    uv_timer_t timer;
-
-    uv_async_t async_handle;
-    async_handle_t *freelist; // 空闲的 handle 列表
-    pthread_mutex_t freelist_lock;
-    int freelist_count;
-
-    _Atomic int64_t async_handle_count;
-    uv_async_t async_weak; // 使用 send 快速唤醒
-} global_handle_t;
-
-extern global_handle_t global;
+typedef enum {
+    IO_BACKEND_LIBUV = 0, // 文件 io 使用 libuv 线程池, socket 使用 epoll
+    IO_BACKEND_URING, // 文件 io 通过每个 loop 的 io_uring 提交, 仅 linux 支持
+} io_backend_t;
 
-// 全局 async 队列变量
-extern uv_loop_t global_loop; // uv loop 事件循环
+extern io_backend_t io_backend;
 
 extern _Atomic uint64_t race_detector_counter;
 
-void global_loop_run(int loop_timeout_ms);
-
-void global_loop_init();
+void processor_loop_init(n_processor_t *p);
 
-void global_async_queue_push(async_fn fn, void *arg);
+void processor_loop_run(n_processor_t *p, int loop_timeout_ms);
 
-void global_async_queue_process_cb(uv_async_t *handle);
-
-void global_async_weak_cb(uv_async_t *handle);
+void processor_async_queue_process_cb(uv_async_t *handle);
 
 extern int cpu_count;
 extern n_processor_t *processor_index[1024];
@@ -74,6 +58,8 @@ extern _Thread_local int64_t tls_yield_safepoint;
 #else
 extern _Thread_local __attribute__((tls_model("local-exec"))) int64_t tls_yield_safepoint;
 #endif
+// 当前线程正在运行的 processor, 与 tls_processor_key 不同, 只在 processor_run 中设置
+extern _Thread_local n_processor_t *tls_run_processor;
 // gc 全局 safepoint 标识，通常配合 stw 使用
 
 typedef struct {
@@ -145,12 +131,45 @@ static inline void _co_yield(n_processor_t *p, coroutine_t *co) {
     p->co_started_at = uv_hrtime();
 }
 
+/**
+ * 当前线程就是 p 的 owner 时直接写入本地链表，否则通过 cas push 到 runnable_list.inbox
+ *
+ * 不能使用 processor_get() 判断 owner, 非 use_t0 模式下主线程的 tls_processor_key 同样指向 P0
+ */
+static inline void processor_runnable_push(n_processor_t *p, coroutine_t *co) {
+    if (tls_run_processor == p) {
+        rt_mpsc_push_local(&p->runnable_list, co);
+    } else {
+        rt_mpsc_push(&p->runnable_list, co);
+    }
+}
+
+/**
+ * co 需要在 p 的下一次调度时运行(mutex handoff)
+ * 其他线程无法修改 owner 本地链表的头部, 所以通过 runnext 槽位交接, 被替换的 coroutine 回到队列尾部
+ */
+static inline void processor_runnable_push_head(n_processor_t *p, coroutine_t *co) {
+    if (tls_run_processor == p) {
+        rt_mpsc_push_head_local(&p->runnable_list, co);
+        return;
+    }
+
+    coroutine_t *old = atomic_exchange(&p->runnext, co);
+    if (old) {
+        rt_mpsc_push(&p->runnable_list, old);
+    }
+}
+
+static inline bool processor_runnable_empty(n_processor_t *p) {
+    return p->runnext == NULL && rt_mpsc_empty(&p->runnable_list);
+}
+
 static inline void co_ready(coroutine_t *co) {
     if (co->p->status == P_STATUS_EXIT) {
         return;
     }
     co_set_status(co->p, co, CO_STATUS_RUNNABLE);
-    rt_linked_fixalloc_push(&co->p->runnable_list, co);
+    processor_runnable_push(co->p, co);
 }
 
 //#define co_ready(co)                                          \
@@ -169,7 +188,7 @@ static inline void co_yield_runnable(n_processor_t *p, coroutine_t *co) {
 
     // syscall -> runnable
     co_set_status(p, co, CO_STATUS_RUNNABLE);
-    rt_linked_fixalloc_push(&p->runnable_list, co);
+    rt_mpsc_push_local(&p->runnable_list, co);
 
     DEBUGF("[runtime.co_yield_runnable] p_index=%d, co=%p, co_status=%d, will yield", p->index, co,
            co->status);
@@ -232,6 +251,10 @@ bool processor_all_safe();
 
 bool processor_all_wait_safe(int max_count);
 
+bool runtime_processor_stw_stats(int64_t index, stw_stats_t *out);
+
+int64_t runtime_processor_count();
+
 void wait_all_gc_work_finished();
 
 /**
@@ -280,7 +303,7 @@ void co_migrate(aco_t *aco, aco_share_stack_t *new_st);
 
 void rt_coroutine_sleep(int64_t ms);
 
-void rt_coroutine_await(coroutine_t *co);
+void rt_coroutine_await(n_future_t *fu);
 
 void rt_coroutine_yield();
 
@@ -290,11 +313,29 @@ void *rt_coroutine_arg();
 
 int64_t rt_processor_index();
 
+char *runtime_io_backend();
+
 // ------------ libuv 的一些回调 -----------------------
 static void sleep_timer_cb(uv_timer_t *timer);
 
-void global_async_send(void *fn, void *arg1, void *arg2, void *arg3);
+/**
+ * 每个 processor 独立持有一个 uv loop, handle 只能在初始化时所在的 loop 线程上操作
+ * - loop_async_send 不等待执行结果, loop_waiting_send 会 yield 当前 coroutine 直到 fn 中调用 co_ready
+ * - 如果当前 processor 就是 loop 的持有者则直接执行 fn, 否则投递到持有者的 async 队列中
+ */
+void loop_async_send(uv_loop_t *loop, void *fn, void *arg1, void *arg2, void *arg3);
+
+void loop_waiting_send(uv_loop_t *loop, void *fn, void *arg1, void *arg2, void *arg3);
+
+/**
+ * 当前线程所属 processor 的 loop, 可以在 coroutine 以及 loop 回调中使用, 新创建的 handle 默认绑定到该 loop
+ * coroutine 开始运行之后不会再被 steal, 所以在其生命周期内 loop 不会变化
+ */
+static inline uv_loop_t *processor_loop() {
+    assert(tls_run_processor);
+    return tls_run_processor->uv_loop;
+}
 
-void global_waiting_send(void *fn, void *arg1, void *arg2, void *arg3);
+void processor_wake(n_processor_t *p);
 
 #endif // NATURE_PROCESSOR_H
@@ -250,6 +250,7 @@ bool rt_chan_send(n_chan_t *chan, void *msg_ptr, bool try) {
         void *dst_ptr = buf_next_ref(chan);
 
         memmove(dst_ptr, msg_ptr, chan->msg_size);
+        rti_write_barrier_range(dst_ptr, chan->msg_size);
 
         pthread_mutex_unlock(&chan->lock);
         return true;
@@ -317,6 +318,7 @@ static void rt_recv(n_chan_t *chan, linkco_t *linkco, void *msg_ptr, scase *case
         // copy linkco->data to buf tail
         void *dst_ptr = buf_next_ref(chan);
         rt_msg_transmit(linkco->co, linkco->data, dst_ptr, false, chan->msg_size);
+        rti_write_barrier_range(dst_ptr, chan->msg_size);
     }
 
     linkco->data = NULL;
@@ -708,6 +710,7 @@ BUFSEND:
     case_success = true;
     void *dst_ptr = buf_next_ref(c);
     memmove(dst_ptr, cas->msg_ptr, c->msg_size);
+    rti_write_barrier_range(dst_ptr, c->msg_size);
     selunlock(cases, lockorder, cases_count);
     goto RETC;
 
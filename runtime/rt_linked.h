@@ -38,14 +38,8 @@ static inline void rt_linked_fixalloc_init(rt_linked_fixalloc_t *l) {
     l->rear = empty;
 }
 
-static inline bool rt_linked_fixalloc_empty(rt_linked_fixalloc_t *l) {
-    pthread_mutex_lock(&l->locker);
-    bool result = l->count == 0;
-    pthread_mutex_unlock(&l->locker);
-    return result;
-}
-
-static inline void rt_linked_fixalloc_push(rt_linked_fixalloc_t *l, void *value) {
+// 返回存储 value 的节点，可以配合 rt_linked_fixalloc_remove 使用
+static inline rt_linked_node_t *rt_linked_fixalloc_push(rt_linked_fixalloc_t *l, void *value) {
     assert(l);
 
     pthread_mutex_lock(&l->locker);
@@ -54,32 +48,15 @@ static inline void rt_linked_fixalloc_push(rt_linked_fixalloc_t *l, void *value)
 
     empty->prev = l->rear;
 
-    l->rear->succ = empty;
-    l->rear->value = value;
+    rt_linked_node_t *node = l->rear;
+    node->succ = empty;
+    node->value = value;
 
     l->rear = empty;
     l->count++;
 
     pthread_mutex_unlock(&l->locker);
-}
-
-// 尾部永远指向一个空白节点
-static inline void rt_linked_fixalloc_push_heap(rt_linked_fixalloc_t *l, void *value) {
-    assert(l);
-
-    pthread_mutex_lock(&l->locker);
-
-    rt_linked_node_t *new_node = fixalloc_alloc(&l->nodealloc);
-
-    new_node->value = value;
-
-    // 头部插入
-    new_node->succ = l->head;
-    l->head->prev = new_node;
-    l->head = new_node;
-    l->count++;
-
-    pthread_mutex_unlock(&l->locker);
+    return node;
 }
 
 static inline void *rt_linked_fixalloc_pop_no_lock(rt_linked_fixalloc_t *l) {
@@ -0,0 +1,131 @@
+#ifndef NATURE_RT_MPSC_H
+#define NATURE_RT_MPSC_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * 侵入式 mpsc 队列, 元素自身提供 next 指针(通过 link_offset 访问), 不需要额外分配节点
+ *
+ * - owner 线程: 使用本地 fifo 链表(head/tail), push_local/pop 都不需要任何原子 rmw 操作
+ * - 其他线程: 通过 cas push 到 inbox(treiber stack), owner pop 时通过一次 exchange 整体取走 inbox,
+ *   反转后追加到本地链表尾部, 从而保持 fifo 顺序
+ *
+ * 同一个元素同一时刻只能存在于一个队列中
+ */
+typedef struct {
+    _Atomic(void *) inbox; // 其他线程 push 的元素, 后进先出
+    uint8_t pad[56]; // inbox 会被其他线程频繁写入，与 owner 本地数据分属不同 cache line
+
+    _Atomic(void *) head; // owner 本地链表, 其他线程只会读取 head 判断是否为空
+    void *tail;
+    uint64_t link_offset;
+} rt_mpsc_t;
+
+#define RT_MPSC_LINK(_q, _value) (*(void **) ((uint8_t *) (_value) + (_q)->link_offset))
+
+static inline void rt_mpsc_init(rt_mpsc_t *q, uint64_t link_offset) {
+    atomic_store_explicit(&q->inbox, NULL, memory_order_relaxed);
+    atomic_store_explicit(&q->head, NULL, memory_order_relaxed);
+    q->tail = NULL;
+    q->link_offset = link_offset;
+}
+
+/**
+ * 任意线程都可以调用
+ */
+static inline void rt_mpsc_push(rt_mpsc_t *q, void *value) {
+    void *old = atomic_load_explicit(&q->inbox, memory_order_relaxed);
+    do {
+        RT_MPSC_LINK(q, value) = old;
+    } while (!atomic_compare_exchange_weak_explicit(&q->inbox, &old, value, memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+/**
+ * 仅 owner 线程调用
+ */
+static inline void rt_mpsc_push_local(rt_mpsc_t *q, void *value) {
+    RT_MPSC_LINK(q, value) = NULL;
+
+    if (q->tail) {
+        RT_MPSC_LINK(q, q->tail) = value;
+    } else {
+        atomic_store_explicit(&q->head, value, memory_order_relaxed);
+    }
+    q->tail = value;
+}
+
+/**
+ * 仅 owner 线程调用, 插入到头部使其下一次被 pop
+ */
+static inline void rt_mpsc_push_head_local(rt_mpsc_t *q, void *value) {
+    void *head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    RT_MPSC_LINK(q, value) = head;
+    if (!head) {
+        q->tail = value;
+    }
+    atomic_store_explicit(&q->head, value, memory_order_relaxed);
+}
+
+/**
+ * 仅 owner 线程调用, 将 inbox 中的元素按照 push 顺序追加到本地链表尾部
+ */
+static inline void rt_mpsc_drain(rt_mpsc_t *q) {
+    void *stack = atomic_exchange_explicit(&q->inbox, NULL, memory_order_acquire);
+    if (!stack) {
+        return;
+    }
+
+    // 反转 treiber stack
+    void *first = NULL;
+    void *last = stack;
+    while (stack) {
+        void *next = RT_MPSC_LINK(q, stack);
+        RT_MPSC_LINK(q, stack) = first;
+        first = stack;
+        stack = next;
+    }
+
+    if (q->tail) {
+        RT_MPSC_LINK(q, q->tail) = first;
+    } else {
+        atomic_store_explicit(&q->head, first, memory_order_relaxed);
+    }
+    q->tail = last;
+}
+
+/**
+ * 仅 owner 线程调用
+ */
+static inline void *rt_mpsc_pop(rt_mpsc_t *q) {
+    if (atomic_load_explicit(&q->inbox, memory_order_relaxed)) {
+        rt_mpsc_drain(q);
+    }
+
+    void *value = atomic_load_explicit(&q->head, memory_order_relaxed);
+    if (!value) {
+        return NULL;
+    }
+
+    void *next = RT_MPSC_LINK(q, value);
+    atomic_store_explicit(&q->head, next, memory_order_relaxed);
+    if (!next) {
+        q->tail = NULL;
+    }
+
+    RT_MPSC_LINK(q, value) = NULL;
+    return value;
+}
+
+/**
+ * 任意线程都可以调用, 非 owner 线程读取到的结果仅作参考
+ */
+static inline bool rt_mpsc_empty(rt_mpsc_t *q) {
+    return atomic_load_explicit(&q->head, memory_order_relaxed) == NULL &&
+           atomic_load_explicit(&q->inbox, memory_order_relaxed) == NULL;
+}
+
+#endif // NATURE_RT_MPSC_H
@@ -196,7 +196,7 @@ bool rt_can_spin(int64_t iter) {
     }
 
     n_processor_t *p = processor_get();
-    if (!rt_linked_fixalloc_empty(&p->runnable_list)) {
+    if (!processor_runnable_empty(p)) {
         return false;
     }
 
@@ -316,9 +316,9 @@ void rt_mutex_waiter_release(rt_mutex_t *m, bool handoff) {
     // 先更新状态避免更新异常
     co_set_status(p, wait_co, CO_STATUS_RUNNABLE);
     if (handoff) {
-        rt_linked_fixalloc_push_heap(&p->runnable_list, wait_co);
+        processor_runnable_push_head(p, wait_co);
     } else {
-        rt_linked_fixalloc_push(&p->runnable_list, wait_co);
+        processor_runnable_push(p, wait_co);
     }
     // 如果 wait_co->p 和当前 co 在同一个 processor 中调度，则直接让出自己的控制权
     coroutine_t *co = coroutine_get();
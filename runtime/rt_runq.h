@@ -0,0 +1,107 @@
+#ifndef NATURE_RT_RUNQ_H
+#define NATURE_RT_RUNQ_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * processor 本地的有界无锁队列(bounded mpmc ring), 存放尚未开始运行的新 coroutine
+ *
+ * 任意线程都可以 push(rt_coroutine_dispatch 会从其他 processor 线程投递),
+ * owner processor 与执行 steal 的空闲 processor 都通过 pop 从 head 消费。
+ * 每个 cell 通过 seq 标记当前所处的轮次, push/pop 只需要对 tail/head 做一次 CAS 即可占有 cell。
+ */
+#define RT_RUNQ_SIZE 256 // 必须是 2 的幂
+#define RT_RUNQ_MASK (RT_RUNQ_SIZE - 1)
+
+typedef struct {
+    _Atomic uint64_t seq;
+    void *value;
+} rt_runq_cell_t;
+
+typedef struct {
+    _Atomic uint64_t head; // pop/steal 位置
+    uint8_t pad0[56]; // head 与 tail 分属不同 cache line, 避免生产者与消费者互相干扰
+    _Atomic uint64_t tail; // push 位置
+    uint8_t pad1[56];
+    rt_runq_cell_t cells[RT_RUNQ_SIZE];
+} rt_runq_t;
+
+static inline void rt_runq_init(rt_runq_t *q) {
+    for (uint64_t i = 0; i < RT_RUNQ_SIZE; ++i) {
+        atomic_store_explicit(&q->cells[i].seq, i, memory_order_relaxed);
+        q->cells[i].value = NULL;
+    }
+
+    atomic_store_explicit(&q->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&q->tail, 0, memory_order_release);
+}
+
+/**
+ * 队列已满时返回 false, 由调用方回退到 runnable_list
+ */
+static inline bool rt_runq_push(rt_runq_t *q, void *value) {
+    uint64_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    rt_runq_cell_t *cell;
+
+    while (true) {
+        cell = &q->cells[pos & RT_RUNQ_MASK];
+        uint64_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int64_t diff = (int64_t) seq - (int64_t) pos;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // cell 还没有被上一轮消费, 队列已满
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+
+    cell->value = value;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+static inline void *rt_runq_pop(rt_runq_t *q) {
+    uint64_t pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+    rt_runq_cell_t *cell;
+
+    while (true) {
+        cell = &q->cells[pos & RT_RUNQ_MASK];
+        uint64_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int64_t diff = (int64_t) seq - (int64_t) (pos + 1);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // cell 尚未写入, 队列为空
+            return NULL;
+        } else {
+            pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+        }
+    }
+
+    void *value = cell->value;
+    atomic_store_explicit(&cell->seq, pos + RT_RUNQ_SIZE, memory_order_release);
+    return value;
+}
+
+/**
+ * 近似值，仅用于 steal 时估算数量与空闲判断
+ */
+static inline uint64_t rt_runq_size(rt_runq_t *q) {
+    uint64_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    return tail > head ? tail - head : 0;
+}
+
+#endif // NATURE_RT_RUNQ_H
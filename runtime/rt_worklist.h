@@ -0,0 +1,53 @@
+#ifndef NATURE_RT_WORKLIST_H
+#define NATURE_RT_WORKLIST_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "utils/assertf.h"
+
+/**
+ * processor 本地的 gc worklist, 由数组实现的后进先出栈
+ *
+ * mark 阶段只有 owner processor 线程会读写(gc_work 与 write barrier 都运行在当前 processor 上),
+ * 其他线程只会在 stw 期间写入(scan_global/scan_pool), 所以不需要任何锁或原子操作。
+ * 多线程写入的场景使用 global_gc_worklist。
+ */
+#define RT_WORKLIST_INIT_CAP 1024
+
+typedef struct {
+    void **data;
+    uint64_t count;
+    uint64_t cap;
+} rt_worklist_t;
+
+static inline void rt_worklist_init(rt_worklist_t *w) {
+    w->data = NULL;
+    w->count = 0;
+    w->cap = 0;
+}
+
+static inline void rt_worklist_push(rt_worklist_t *w, void *value) {
+    if (w->count == w->cap) {
+        w->cap = w->cap ? w->cap * 2 : RT_WORKLIST_INIT_CAP;
+        w->data = realloc(w->data, w->cap * sizeof(void *));
+        assertf(w->data, "gc worklist grow failed, cap=%lu", w->cap);
+    }
+
+    w->data[w->count++] = value;
+}
+
+static inline void *rt_worklist_pop(rt_worklist_t *w) {
+    if (w->count == 0) {
+        return NULL;
+    }
+
+    return w->data[--w->count];
+}
+
+static inline void rt_worklist_free(rt_worklist_t *w) {
+    free(w->data);
+    rt_worklist_init(w);
+}
+
+#endif // NATURE_RT_WORKLIST_H
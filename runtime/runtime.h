@@ -10,6 +10,9 @@
 #include "gcbits.h"
 #include "nutils/nutils.h"
 #include "rt_linked.h"
+#include "rt_mpsc.h"
+#include "rt_runq.h"
+#include "rt_worklist.h"
 #include "sizeclass.h"
 #include "utils/bitmap.h"
 #include "utils/custom_links.h"
@@ -100,6 +103,12 @@ static inline bool user_main_is_fn(void) {
 
 #define ARENA_BITS_COUNT 2097152 // 1byte = 8bit 可以索引 4*8byte = 32byte 空间, 64MB 空间需要 64*1024*1024 / 32
 
+#define CARD_SHIFT 9 // 一个 card 管理 512byte 的堆空间, card 不会跨越 page
+
+#define CARD_SIZE (1 << CARD_SHIFT)
+
+#define ARENA_CARDS_COUNT (ARENA_SIZE >> CARD_SHIFT) // 64MB 空间需要 131072 个 card
+
 #define PAGE_ALLOC_CHUNK_SPLIT 8192 // 每组 chunks 中的元素的数量
 
 #define MMAP_SHARE_STACK_BASE 0xa000000000
@@ -158,6 +167,10 @@ static inline bool user_main_is_fn(void) {
 
 #define GC_PERCENT 100
 
+#define GC_GEN_FULL_INTERVAL 8 // 分代模式下连续进行 minor gc 的最大次数, 超过后进行一次 full gc 回收老年代垃圾
+
+#define SWEEP_SPAN_BUDGET 100 // cache_span 单次最多按需清理的 span 数量, 超过后直接 grow, 剩余的交给后台清理
+
 #define WAIT_BRIEF_TIME 1 // ms
 #define WAIT_SHORT_TIME 10 // ms
 #define WAIT_MID_TIME 50 // ms
@@ -223,6 +236,10 @@ typedef struct {
 
     mspan_t *partial_list; // 还有空闲 span obj 的链表
     mspan_t *full_list;
+
+    // mark 完成后 partial/full 整体移动到 unswept 中, 由 cache_span 按需清理或者由 gc 线程在后台清理
+    mspan_t *unswept_partial_list;
+    mspan_t *unswept_full_list;
 } mcentral_t;
 
 typedef struct {
@@ -283,6 +300,9 @@ typedef struct {
     // 可以是一个 span 存在于多个 page_index 中, 一个 span 的最小内存是 8k, 所以一个 page 最多只能存储一个 span.
     mspan_t *spans[ARENA_PAGES_COUNT]; // page = 8192, 所以 pages 的数量是固定的
 
+    // 分代模式下由写屏障标记, 1 表示 card 中的 obj 在上一轮 gc 之后写入过指针, minor gc 时作为老年代到新生代的 root
+    uint8_t cards[ARENA_CARDS_COUNT];
+
     addr_t base;
 } arena_t;
 
@@ -307,7 +327,12 @@ typedef struct {
     arena_t *arenas[ARENA_COUNT];
 
     mcentral_t centrals[SPANCLASS_COUNT];
+
+    // 每轮 gc 在 mark 完成时 + 2, span.sweepgen == sweepgen - 2 表示尚未清理, sweepgen - 1 表示正在清理,
+    // sweepgen 表示已经清理完成
     uint32_t sweepgen;
+    atomic_int_fast64_t sweepers; // 正在清理 span 的线程数量
+    bool sticky_mark; // 本轮 sweep 保留存活 obj 的 gcmark_bits, 下一轮 gc 是 minor gc
     slice_t *spans; // 所有分配的 span 都会在这里被引用
     arena_hint_t *arena_hints;
 
@@ -373,10 +398,22 @@ struct linkco_t {
 typedef struct n_future_t {
     int64_t size;
     void *result;
-    n_union_t error; // 类似 result 一样可选的 error
-    void *await_co;
+    // 对应 throwable? error, union 的 value 按照最大元素(interface)的大小内联存储, 不能直接使用 n_union_t
+    struct {
+        rtype_t *rtype;
+        n_interface_t value;
+    } error;
+
+    // 对应 future_t.co, 由 runtime 维护, 取值有三种状态:
+    // - coroutine_t*: coroutine 尚未退出
+    // - coroutine_t* | FUTURE_AWAIT_TAG: 已经有 await 的 coroutine 在等待(指针为等待方)
+    // - NULL: coroutine 已经退出
+    // coroutine 退出后会被 gc_work 回收复用, 所以 await 不能再访问 coroutine_t 本身, 只能通过 future 同步
+    void *co;
 } n_future_t;
 
+#define FUTURE_AWAIT_TAG 1
+
 struct coroutine_t {
     int64_t id;
     bool main; // 是否是 main 函数
@@ -394,9 +431,6 @@ struct coroutine_t {
 
     n_future_t *future;
 
-    struct coroutine_t *await_co; // 可能为 null, 如果不为 null 说明该 co 在等待当前 co exit
-    mutex_t dead_locker;
-
     // 当前 coroutine stack 颜色是否为黑色, 黑色说明当前 goroutine stack 已经扫描完毕
     // gc stage 是 mark 时, 当 gc_black 值小于 memory->gc_count 时，说明当前 coroutine stack 不是黑色的
     uint64_t gc_black;
@@ -448,9 +482,22 @@ struct coroutine_t {
     unlock_fn wait_unlock_fn;
     void *wait_lock;
 
+    rt_linked_node_t *co_node; // 在 p->co_list 中的节点, steal 迁移 processor 时使用
+
     struct coroutine_t *next; // coroutine list
 };
 
+/**
+ * processor 维度的 stw 统计, 只有 processor 自身的线程会写入, 与 std/runtime stw_stats_t 的内存布局保持一致
+ */
+typedef struct {
+    int64_t stw_count;
+    int64_t safepoint_total_ns; // 从 stw 请求到进入安全点的耗时
+    int64_t safepoint_max_ns;
+    int64_t resume_total_ns; // 从 start the world 到 processor 被唤醒的耗时
+    int64_t resume_max_ns;
+} stw_stats_t;
+
 /**
  * 位于 share_processor_t 中的协程，如果运行时间过长会被抢占式调度
  * 共享处理器的数量通畅等于线程的数量, 所以可以将线程维度的无锁内存分配器放置再这里
@@ -465,9 +512,16 @@ struct n_processor_t {
 #ifndef __WINDOWS
     struct sigaction sig;
 #endif
-    uv_timer_t timer; // 辅助协程调度的定时器
+    uv_loop_t *uv_loop; // processor 独立的事件循环, uv_loop->data = p, 只有 p 的线程会运行该 loop
+    uv_timer_t timer; // uv_run 的超时定时器
+    uv_async_t async_handle; // 其他线程投递任务之后唤醒 uv_loop
+    struct async_handle_t *async_queue; // 投递到 uv_loop 的任务, 通过 async_lock 保护
+    pthread_mutex_t async_lock;
+    struct async_handle_t *async_freelist; // 只有 p 的线程会访问, 不需要加锁
+    int async_freelist_count;
     //    uint64_t need_stw; // 外部声明, 内部判断 是否需要 stw
     uint64_t in_stw; // 外部判断是否已经 stw
+    stw_stats_t stw_stats;
 
     // 当前 p 需要被其他线程读取的一些属性都通过该锁进行保护
     // - 如更新 p 对应的 co 的状态等
@@ -484,9 +538,13 @@ struct n_processor_t {
     uint8_t linkco_count;
 
     rt_linked_fixalloc_t co_list; // 当前 processor 下的 coroutine 列表
-    rt_linked_fixalloc_t runnable_list;
+    rt_mpsc_t runnable_list; // 通过 coroutine_t.next 链接, owner 线程 push/pop 不需要锁
+    coroutine_t *runnext; // 其他线程 handoff 的 coroutine, 在 runnable_list 之前调度
+    rt_runq_t runq; // 尚未开始运行的新 coroutine, 空闲的 processor 可以从这里 steal
+    uint32_t sched_tick; // 调度计数，用于在 runnable_list 与 runq 之间保持公平
+    uint64_t steal_rand; // steal 时随机选择 victim 的种子
 
-    rt_linked_fixalloc_t gc_worklist; // gc 扫描的 ptr 节点列表
+    rt_worklist_t gc_worklist; // gc 扫描的 ptr 节点列表
     uint64_t gc_work_finished; // 当前处理的 GC 轮次，每完成一轮 + 1
 
     struct sc_map_64v caller_cache; // 函数缓存定义
@@ -231,8 +231,8 @@ static void processor_sysmon() {
     // - 监控长时间被占用的 share processor 进行抢占式调度
     PROCESSOR_FOR(processor_list) {
         // 没有需要运行的 runnable_list(等待运行的 runnable) 并且当前也不需要 stw 则不需要则不考虑抢占
-        if (global_safepoint.value == 0 && p->runnable_list.count == 0) {
-            DEBUGF("[processor_sysmon] p_index=%d p_status=%d runnable_list.count == 0 cannot preempt, will skip", p->index, p->status);
+        if (global_safepoint.value == 0 && processor_runnable_empty(p)) {
+            DEBUGF("[processor_sysmon] p_index=%d p_status=%d runnable_list empty cannot preempt, will skip", p->index, p->status);
             continue;
         }
 
@@ -269,19 +269,10 @@ static void processor_sysmon() {
     }
 }
 
-static void on_timer_stop_cb(uv_timer_t *timer) {
-    uv_timer_stop(timer);
-
-    uv_stop(&global_loop);
-}
-
 static void wait_sysmon() {
     // 每 50 * 10ms 进行 eval 一次
     int gc_eval_count = WAIT_SHORT_TIME;
 
-    //    uv_timer_t timer;
-    //    uv_timer_init(&global_loop, &timer);
-
     // 循环监控(每 10ms 监控一次)
     while (true) {
         DEBUGF("[wait_sysmon] will processor sysmon ");
@@ -298,10 +289,6 @@ static void wait_sysmon() {
         gc_eval_count--;
 
         usleep(WAIT_SHORT_TIME * 1000); // 10ms
-
-        // libuv loop with io 10ms
-        //        uv_timer_start(&timer, on_timer_stop_cb, 10, 0); // 只触发一次
-        //        uv_run(&global_loop, UV_RUN_DEFAULT);
     }
 }
 
@@ -400,6 +400,23 @@ static lir_operand_t *linear_super_move(module_t *m, type_t t, lir_operand_t *ds
     return dst;
 }
 
+/**
+ * string/vec/struct 等包含指针的值整体写入 dst_ref 指向的内存之后, 由 runtime 进行 card 标记以及 mark 阶段的重新扫描
+ * dst_ref 可能指向栈, runtime 中会直接跳过
+ */
+static void linear_write_barrier_range(module_t *m, type_t t, lir_operand_t *dst_ref) {
+    if (!type_has_heap_ptr(t)) {
+        return;
+    }
+
+    // struct 类型的 var 中存储的是地址, 转换为 ref 避免作为参数时按值传递
+    if (lir_operand_type(dst_ref).storage_kind == STORAGE_KIND_IND) {
+        dst_ref = lea_operand_pointer(m, dst_ref);
+    }
+
+    push_rt_call(m, RT_CALL_WRITE_BARRIER_RANGE, NULL, 2, dst_ref, int_operand(t.storage_size));
+}
+
 static lir_operand_t *linear_default_string(module_t *m, type_t t, lir_operand_t *target) {
     if (!target) {
         target = temp_var_operand_with_alloc(m, t);
@@ -1138,11 +1155,13 @@ static void linear_vec_assign(module_t *m, ast_assign_stmt_t *stmt) {
         // target 已经是指针了，不需要再次计算 slot
         push_rt_call(m, RT_CALL_WRITE_BARRIER, NULL, 2, target, src);
     } else {
+        lir_operand_t *dst_ref = target;
         if (vec_element_type.storage_kind == STORAGE_KIND_DIR) {
             target = indirect_addr_operand(m, vec_element_type, target, 0);
         }
 
         linear_super_move(m, vec_element_type, target, src);
+        linear_write_barrier_range(m, vec_element_type, dst_ref);
     }
 }
 
@@ -1156,6 +1175,9 @@ static void linear_array_assign(module_t *m, ast_assign_stmt_t *stmt) {
         push_rt_call(m, RT_CALL_WRITE_BARRIER, NULL, 2, dst_slot, new_obj);
     } else {
         linear_expr(m, stmt->right, target);
+        if (stmt->left.type.storage_kind == STORAGE_KIND_IND) {
+            linear_write_barrier_range(m, stmt->left.type, target);
+        }
     }
 }
 
@@ -1181,6 +1203,9 @@ static void linear_tuple_assign(module_t *m, ast_assign_stmt_t *stmt) {
         }
 
         linear_expr(m, stmt->right, dst);
+        if (stmt->left.type.storage_kind == STORAGE_KIND_IND) {
+            linear_write_barrier_range(m, stmt->left.type, dst);
+        }
     }
 }
 
@@ -1225,6 +1250,7 @@ static void linear_env_assign(module_t *m, ast_assign_stmt_t *stmt) {
 
         if (stmt->left.type.storage_kind == STORAGE_KIND_IND) {
             linked_concat(m->current_closure->operations, lir_memory_mov(m, size, dst_ptr, src));
+            linear_write_barrier_range(m, stmt->left.type, dst_ptr);
         } else {
             lir_operand_t *dst = indirect_addr_operand(m, stmt->left.type, dst_ptr, 0);
             OP_PUSH(lir_op_move(dst, src)); // dir
@@ -1253,10 +1279,12 @@ static void linear_map_assign(module_t *m, ast_assign_stmt_t *stmt) {
         lir_operand_t *obj = linear_expr(m, stmt->right, NULL);
         push_rt_call(m, RT_CALL_WRITE_BARRIER, NULL, 2, dst, obj);
     } else {
+        lir_operand_t *dst_ref = dst;
         if (stmt->right.type.storage_kind != STORAGE_KIND_IND) {
             dst = indirect_addr_operand(m, stmt->right.type, dst, 0);
         }
         linear_expr(m, stmt->right, dst);
+        linear_write_barrier_range(m, stmt->left.type, dst_ref);
     }
 }
 
@@ -1301,6 +1329,9 @@ static void linear_struct_assign(module_t *m, ast_assign_stmt_t *stmt) {
             dst_slot = lea_operand_pointer(m, dst_slot);
         }
         linear_expr(m, stmt->right, dst_slot);
+        if (stmt->left.type.storage_kind == STORAGE_KIND_IND) {
+            linear_write_barrier_range(m, stmt->left.type, dst_slot);
+        }
     }
 }
 
@@ -1316,6 +1347,11 @@ static void linear_ia_ptr_assign(module_t *m, ast_assign_stmt_t *stmt) {
 
     // *ptr = [a, b, c]
     // *ptr = 12
+    if (is_gc_alloc(stmt->left.type.kind)) {
+        push_rt_call(m, RT_CALL_WRITE_BARRIER, NULL, 2, ptr_operand, src);
+        return;
+    }
+
     lir_operand_t *dst;
     if (stmt->left.type.storage_kind == STORAGE_KIND_IND) {
         dst = ptr_operand; // super_move 会自动进行全尺寸移动
@@ -1324,6 +1360,9 @@ static void linear_ia_ptr_assign(module_t *m, ast_assign_stmt_t *stmt) {
     }
 
     linear_super_move(m, stmt->left.type, dst, src);
+    if (stmt->left.type.storage_kind == STORAGE_KIND_IND) {
+        linear_write_barrier_range(m, stmt->left.type, ptr_operand);
+    }
 }
 
 /**
@@ -1341,6 +1380,16 @@ static void linear_ident_assign(module_t *m, ast_assign_stmt_t *stmt) {
 
     assert(stmt->left.type.kind > 0 && stmt->left.type.kind != TYPE_UNKNOWN);
     linear_super_move(m, stmt->left.type, dst, src);
+
+    // 逃逸到堆中的 struct/string 等变量
+    ast_ident *ident = stmt->left.value;
+    symbol_t *s = symbol_table_get(ident->literal);
+    if (s->type == SYMBOL_VAR && s->is_local && stmt->left.type.storage_kind == STORAGE_KIND_IND) {
+        ast_var_decl_t *symbol_var = s->ast_value;
+        if (symbol_var->heap_ident || symbol_var->type.in_heap) {
+            linear_write_barrier_range(m, stmt->left.type, dst);
+        }
+    }
 }
 
 /**
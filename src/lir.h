@@ -65,6 +65,8 @@
 
 #define RT_CALL_WRITE_BARRIER "write_barrier"
 
+#define RT_CALL_WRITE_BARRIER_RANGE "write_barrier_range"
+
 #define RT_CALL_PTR_VALID "ptr_valid"
 
 #define RT_CALL_MAP_NEW "rt_map_new"
@@ -252,7 +254,7 @@ static inline bool is_rtcall(string target) {
     return str_equal(target, RT_CALL_SET_ADD) || str_equal(target, RT_CALL_SET_DELETE) ||
            str_equal(target, RT_CALL_SET_CONTAINS) || str_equal(target, RT_CALL_SET_NEW) ||
            str_equal(target, RT_CALL_VEC_CAP) || str_equal(target, RT_CALL_ARRAY_NEW) ||
-           str_equal(target, RT_CALL_WRITE_BARRIER) ||
+           str_equal(target, RT_CALL_WRITE_BARRIER) || str_equal(target, RT_CALL_WRITE_BARRIER_RANGE) ||
            str_equal(target, RT_CALL_PTR_VALID) ||
            str_equal(target, RT_CALL_MAP_NEW) || str_equal(target, RT_CALL_MAP_ACCESS) ||
            str_equal(target, RT_CALL_MAP_ASSIGN) || str_equal(target, RT_CALL_MAP_LENGTH) ||
@@ -0,0 +1,7 @@
+#include "tests/test.h"
+
+int main(void) {
+    // 多个 processor 才会出现跨线程的 dispatch 与 await 唤醒
+    setenv("NATURE_MAXPROCS", "2", 1);
+    feature_testar_test(NULL);
+}
@@ -0,0 +1,7 @@
+#include "tests/test.h"
+#include <stdlib.h>
+
+int main(void) {
+    setenv("NATURE_MAXPROCS", "4", 1);
+    feature_testar_test(NULL);
+}
@@ -224,6 +224,7 @@ typedef struct {
     // runtime GC_RTYPE 使用该字段(malloc_gc_bits_offset 中的数据无法再进一步修改)
     uint64_t gc_bits; // 从右到左，每个 bit 代表一个指针的位置，如果为 1，表示该位置是一个指针，需要 gc
     uint8_t align; // struct/list 最终对齐的字节数
+    uint8_t key_kind; // runtime 作为 map/set key 时使用的 hash/equal 方式, 0 表示尚未计算, 占用 padding 不改变 rtype_t 布局
     uint16_t length; // struct/tuple/array 类型的长度
     int64_t hashes_offset;
 } rtype_t;
@@ -1040,6 +1041,42 @@ static inline bool is_gc_alloc(type_kind kind) {
            kind == TYPE_FN;
 }
 
+/**
+ * 值中是否包含需要 gc 扫描的指针, struct/array/tuple 递归判断, 与 rtype 的 last_ptr > 0 保持一致
+ * union/any/interface 等类型无法在编译时确定 value, 所以总是认为包含指针
+ */
+static inline bool type_has_heap_ptr(type_t t) {
+    if (is_gc_alloc(t.kind)) {
+        return true;
+    }
+
+    if (t.kind == TYPE_STRUCT) {
+        for (int i = 0; i < t.struct_->properties->length; ++i) {
+            struct_property_t *p = ct_list_value(t.struct_->properties, i);
+            if (type_has_heap_ptr(p->type)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (t.kind == TYPE_ARR) {
+        return t.array->length > 0 && type_has_heap_ptr(t.array->element_type);
+    }
+
+    if (t.kind == TYPE_TUPLE) {
+        for (int i = 0; i < t.tuple->elements->length; ++i) {
+            type_t *element_type = ct_list_value(t.tuple->elements, i);
+            if (type_has_heap_ptr(*element_type)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    return type_storage_kind(t) == STORAGE_KIND_IND;
+}
+
 /**
  * 不需要进行类型还原的类型
  * @param t